@@ -5,16 +5,24 @@
 #include <cstdint>
 
 #include "types.h"
+#include "affected_set.h"
 #include "../common/pvector.h"
 
+// non-virtual degree lookups into the arrays kept by dataStruc
+struct degree_view {
+    const int64_t* out;
+    const int64_t* in;
+    int64_t out_degree(NodeID n) const { return out[n]; }
+    int64_t in_degree(NodeID n) const { return in[n]; }
+};
+
 class dataStruc {
 public:        
     int64_t num_nodes = 0;
     int64_t num_edges = 0; 
     bool weighted;
     bool directed;
-    std::vector<float> property;
-    pvector<bool> affected;
+    affected_set affected;
     dataStruc(bool _weighted, bool _directed):
         weighted(_weighted),
         directed(_directed) {}
@@ -24,5 +32,31 @@ public:
     virtual ~dataStruc(){}
     virtual int64_t in_degree(NodeID n) = 0;
     virtual int64_t out_degree(NodeID n) = 0;      
+
+    // Dense degree arrays, refreshed by sync_degrees() for the endpoints of
+    // every batch, so algorithms read degrees without virtual calls or locks.
+    std::vector<int64_t> out_degrees;
+    std::vector<int64_t> in_degrees;    // only filled for directed graphs
+
+    // call after update(), before affected is cleared; affected holds each
+    // endpoint once, so every degree is read once and written by one thread
+    void sync_degrees() {
+        if (static_cast<int64_t>(out_degrees.size()) < num_nodes) {
+            out_degrees.resize(num_nodes, 0);
+            if (directed)
+                in_degrees.resize(num_nodes, 0);
+        }
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int64_t k = 0; k < affected.size(); k++) {
+            NodeID n = affected.begin()[k];
+            out_degrees[n] = out_degree(n);
+            if (directed)
+                in_degrees[n] = in_degree(n);
+        }
+    }
+
+    degree_view degrees() const {
+        return degree_view{out_degrees.data(), directed ? in_degrees.data() : out_degrees.data()};
+    }
 };
 #endif
\ No newline at end of file
@@ -38,13 +38,13 @@ bool adList<T>::vertexExists(const Edge& e, bool source)
 	exists = e.destExists;
     if (exists) {        
         num_edges++;        
-        if(source) affected[e.source] = 1;
-        else affected[e.destination] = 1;
+        affected.insert(source ? e.source : e.destination);
         return true;
     } else {
         num_nodes++;        
         num_edges++;
-        affected.push_back(1);
+        affected.resize(num_nodes);
+        affected.insert(source ? e.source : e.destination);
         return false;
     }  
 }
@@ -52,7 +52,6 @@ bool adList<T>::vertexExists(const Edge& e, bool source)
 template <typename T>
 void adList<T>::updateForNewVertex(const Edge& e, bool source)
 {
-    property.push_back(-1);      
     if (source || (!source && !directed)) {
         // update out_neighbors with meaningful data
         std::vector<T> edge_data;
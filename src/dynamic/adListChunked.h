@@ -58,6 +58,11 @@ class adListChunked: public dataStruc {
       void print() override;
       int64_t in_degree(NodeID n) override;
       int64_t out_degree(NodeID n) override;      
+      // whole neighbor vector of n, for block-wise traversal
+      const std::vector<T>& neighbors(NodeID n, bool in_neigh) const {
+          const vector<unique_ptr<partition>> &parts = in_neigh ? in : out;
+          return parts[pt_hash(n)]->partAdList->neighbors[hash_within_chunk(n)];
+      }
 };
 
 // dfa----------------------------------Partition----------------------------------------
@@ -95,9 +100,8 @@ adListChunked<T>::adListChunked(bool w, bool d, int64_t _num_nodes, int64_t _num
     else
         num_partitions = _num_parts;
     cout << "Num parts: " << _num_parts << endl;
-    // initialize 1) property 2) affected 3) vertices vectors 4) markers
-    property.resize(num_nodes_initialize, -1);
-    affected.resize(num_nodes_initialize); affected.fill(false);
+    // initialize 1) affected 2) vertices vectors 3) markers
+    affected.resize(num_nodes_initialize);
 
     for (int i = 0; i < num_partitions / 2; i++) {
         if (directed) {
@@ -127,9 +131,8 @@ adListChunked<T>::adListChunked(bool w, bool d, int64_t _num_nodes)
     num_nodes_initialize = _num_nodes;
     num_partitions = 16;
 
-    // initialize 1) property 2) affected 3) vertices vectors 4) markers
-    property.resize(num_nodes_initialize, -1);
-    affected.resize(num_nodes_initialize); affected.fill(false);
+    // initialize 1) affected 2) vertices vectors 3) markers
+    affected.resize(num_nodes_initialize);
 
     for (int i = 0; i < num_partitions / 2; i++) {
         if (directed) {
@@ -292,8 +295,8 @@ void adListChunked<T>::update(const EdgeList& el) {
             num_nodes++;
         if (!el[i].destExists)
             num_nodes++;
-        affected[el[i].source] = true;
-        affected[el[i].destination] = true;
+        affected.insert(el[i].source);
+        affected.insert(el[i].destination);
 
 	    o_ix = pt_hash(el[i].source);
 	    i_ix = pt_hash(e_reverse.source);
@@ -0,0 +1,225 @@
+#include "adListCompressed.h"
+
+bool compare_and_swap(bool &x, const bool &old_val, const bool &new_val);
+
+static void varint_encode(uint64_t v, std::vector<uint8_t> &out)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+static uint64_t zigzag_encode(int64_t v)
+{
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+void compressed_list::decode(const compressed_block &b, bool weighted, std::vector<entry> &out)
+{
+    const uint8_t* p = b.bytes.data();
+    NodeID id = 0;
+    for (uint32_t k = 0; k < b.count; k++) {
+        id += varint_decode(p);
+        Weight w = weighted ? zigzag_decode(varint_decode(p)) : -1;
+        out.emplace_back(id, w);
+    }
+}
+
+// encode sorted [first, last) into evenly filled blocks appended to out
+void compressed_list::encode(std::vector<entry>::const_iterator first,
+                             std::vector<entry>::const_iterator last,
+                             bool weighted, std::vector<compressed_block> &out)
+{
+    int64_t n = last - first;
+    int64_t num_blocks = (n + max_block_edges - 1) / max_block_edges;
+    std::vector<uint8_t> buf;
+    for (int64_t b = 0; b < num_blocks; b++) {
+        auto begin = first + n * b / num_blocks;
+        auto end = first + n * (b + 1) / num_blocks;
+        buf.clear();
+        NodeID prev = 0;
+        for (auto it = begin; it != end; ++it) {
+            varint_encode(it->first - prev, buf);
+            if (weighted)
+                varint_encode(zigzag_encode(it->second), buf);
+            prev = it->first;
+        }
+        compressed_block block;
+        block.first = begin->first;
+        block.count = end - begin;
+        block.bytes.assign(buf.begin(), buf.end());
+        out.push_back(std::move(block));
+    }
+}
+
+/* Merge sorted, duplicate-free entries into the list. Existing entries take
+   the new weight. Returns the number of entries that were not present. */
+int64_t compressed_list::merge(std::vector<entry>::const_iterator first,
+                             std::vector<entry>::const_iterator last, bool weighted)
+{
+    if (blocks.empty()) {
+        encode(first, last, weighted, blocks);
+        degree += last - first;
+        return last - first;
+    }
+
+    int64_t added = 0;
+    std::vector<compressed_block> merged_blocks;
+    std::vector<entry> old_entries, merged;
+    size_t b = 0;
+    auto it = first;
+    while (it != last) {
+        // last block whose first ID is <= the next new ID
+        while (b + 1 < blocks.size() && blocks[b + 1].first <= it->first)
+            b++;
+        auto group_end = it;
+        while (group_end != last &&
+               (b + 1 == blocks.size() || group_end->first < blocks[b + 1].first))
+            ++group_end;
+
+        old_entries.clear();
+        decode(blocks[b], weighted, old_entries);
+        merged.clear();
+        auto o = old_entries.cbegin();
+        for (; it != group_end; ++it) {
+            while (o != old_entries.cend() && o->first < it->first)
+                merged.push_back(*o++);
+            if (o != old_entries.cend() && o->first == it->first)
+                ++o;
+            else
+                added++;
+            merged.push_back(*it);
+        }
+        merged.insert(merged.end(), o, old_entries.cend());
+
+        merged_blocks.clear();
+        encode(merged.cbegin(), merged.cend(), weighted, merged_blocks);
+        blocks[b] = std::move(merged_blocks[0]);
+        if (merged_blocks.size() > 1) {
+            blocks.insert(blocks.begin() + b + 1,
+                          std::make_move_iterator(merged_blocks.begin() + 1),
+                          std::make_move_iterator(merged_blocks.end()));
+            b += merged_blocks.size() - 1;
+        }
+    }
+    degree += added;
+    return added;
+}
+
+size_t compressed_list::encoded_bytes() const
+{
+    size_t bytes = 0;
+    for (const compressed_block &b : blocks)
+        bytes += b.bytes.size();
+    return bytes;
+}
+
+adListCompressed::adListCompressed(bool w, bool d, int64_t _num_nodes):
+    dataStruc(w, d),
+    num_nodes_initialize(_num_nodes)
+{
+    affected.resize(num_nodes_initialize);
+    out_neighbors.resize(num_nodes_initialize);
+    if (directed)
+        in_neighbors.resize(num_nodes_initialize);
+}
+
+void adListCompressed::processMetaData(const Edge& e, bool source)
+{
+    bool exists = source ? e.sourceExists : e.destExists;
+    NodeID v = source ? e.source : e.destination;
+
+    affected.insert(v);
+
+    if (!exists)
+        stinger_int64_fetch_add(&num_nodes, 1);
+    stinger_int64_fetch_add(&num_edges, 1);
+}
+
+void adListCompressed::insert(std::vector<compressed_list> &lists,
+                              std::vector<std::pair<NodeID, compressed_list::entry>> &edges)
+{
+    typedef std::pair<NodeID, compressed_list::entry> keyed;
+    // stable, so the last copy of a duplicate edge is the latest one
+    std::stable_sort(edges.begin(), edges.end(), [](const keyed &a, const keyed &b) {
+        return a.first != b.first ? a.first < b.first : a.second.first < b.second.first;
+    });
+
+    // one sorted, duplicate-free run of entries per source vertex
+    std::vector<compressed_list::entry> entries;
+    std::vector<std::pair<NodeID, size_t>> runs;
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (i + 1 < edges.size() && edges[i + 1].first == edges[i].first &&
+            edges[i + 1].second.first == edges[i].second.first)
+            continue;
+        if (runs.empty() || runs.back().first != edges[i].first)
+            runs.emplace_back(edges[i].first, entries.size());
+        entries.push_back(edges[i].second);
+    }
+    runs.emplace_back(-1, entries.size());
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int64_t r = 0; r < int64_t(runs.size()) - 1; r++) {
+        lists[runs[r].first].merge(entries.cbegin() + runs[r].second,
+                                   entries.cbegin() + runs[r + 1].second, weighted);
+    }
+}
+
+void adListCompressed::update(const EdgeList& el)
+{
+    #pragma omp parallel for
+    for (unsigned int k = 0; k < el.size(); k++) {
+        processMetaData(el[k], true);
+        processMetaData(el[k], false);
+    }
+
+    std::vector<std::pair<NodeID, compressed_list::entry>> out_edges, in_edges;
+    out_edges.reserve(directed ? el.size() : 2 * el.size());
+    if (directed)
+        in_edges.reserve(el.size());
+    for (const Edge &e : el) {
+        out_edges.emplace_back(e.source, compressed_list::entry(e.destination, e.weight));
+        if (directed)
+            in_edges.emplace_back(e.destination, compressed_list::entry(e.source, e.weight));
+        else
+            out_edges.emplace_back(e.destination, compressed_list::entry(e.source, e.weight));
+    }
+    insert(out_neighbors, out_edges);
+    if (directed)
+        insert(in_neighbors, in_edges);
+}
+
+int64_t adListCompressed::in_degree(NodeID n)
+{
+    if (directed)
+        return in_neighbors[n].degree;
+    else
+        return out_neighbors[n].degree;
+}
+
+int64_t adListCompressed::out_degree(NodeID n)
+{
+    return out_neighbors[n].degree;
+}
+
+void adListCompressed::print()
+{
+    int64_t stored = 0;
+    size_t payload = 0, headers = 0;
+    for (const std::vector<compressed_list>* lists : {&out_neighbors, &in_neighbors}) {
+        for (const compressed_list &l : *lists) {
+            stored += l.degree;
+            payload += l.encoded_bytes();
+            headers += l.blocks.size() * sizeof(compressed_block);
+        }
+    }
+    std::cout << " numNodes: " << num_nodes <<
+            " numEdges: " << num_edges <<
+            " weighted: " << weighted <<
+            " directed: " << directed <<
+            " payloadBytesPerEdge: " << (stored ? double(payload) / stored : 0) <<
+            " bytesPerEdge: " << (stored ? double(payload + headers) / stored : 0) <<
+    std::endl;
+}
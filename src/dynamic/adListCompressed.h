@@ -0,0 +1,84 @@
+#ifndef ADLISTCOMPRESSED_H_
+#define ADLISTCOMPRESSED_H_
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "abstract_data_struc.h"
+#include "stinger_atomics.h"
+#include "print.h"
+
+/* Adjacency list with compressed neighbor blocks.
+
+   Every vertex keeps its neighbors sorted by ID in blocks of at most
+   max_block_edges entries. A block stores its first ID in the header for
+   searching; its payload encodes each entry as the byte-aligned varint of the
+   gap to the previous ID (the first gap is taken from 0), followed by the
+   zigzag varint of the weight on weighted graphs. Sorted IDs of real graphs
+   have small gaps, so most neighbors take one or two bytes instead of eight.
+
+   A batch is merged per vertex: each new edge goes to the last block whose
+   first ID is not larger, and only the blocks that receive edges are decoded,
+   merged and re-encoded, splitting them when they grow past the limit. */
+
+inline uint64_t varint_decode(const uint8_t* &p)
+{
+    uint64_t v = 0;
+    int shift = 0;
+    while (*p & 0x80) {
+        v |= static_cast<uint64_t>(*p++ & 0x7f) << shift;
+        shift += 7;
+    }
+    v |= static_cast<uint64_t>(*p++) << shift;
+    return v;
+}
+
+inline int64_t zigzag_decode(uint64_t v)
+{
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+struct compressed_block {
+    NodeID first;                   // ID of the first entry, for searching
+    uint32_t count;                 // number of entries
+    std::vector<uint8_t> bytes;     // encoded entries
+};
+
+class compressed_list {
+public:
+    typedef std::pair<NodeID, Weight> entry;
+    static const uint32_t max_block_edges = 64;
+
+    std::vector<compressed_block> blocks;
+    int64_t degree = 0;
+
+    int64_t merge(std::vector<entry>::const_iterator first,
+                  std::vector<entry>::const_iterator last, bool weighted);
+    size_t encoded_bytes() const;
+
+    static void decode(const compressed_block &b, bool weighted, std::vector<entry> &out);
+    static void encode(std::vector<entry>::const_iterator first,
+                       std::vector<entry>::const_iterator last,
+                       bool weighted, std::vector<compressed_block> &out);
+};
+
+class adListCompressed: public dataStruc {
+    private:
+      int64_t num_nodes_initialize;
+      void processMetaData(const Edge& e, bool source);
+      void insert(std::vector<compressed_list> &lists,
+                  std::vector<std::pair<NodeID, compressed_list::entry>> &edges);
+
+    public:
+      std::vector<compressed_list> out_neighbors;
+      std::vector<compressed_list> in_neighbors;    // only filled for directed graphs
+      adListCompressed(bool w, bool d, int64_t _num_nodes);
+      void update(const EdgeList& el) override;
+      void print() override;
+      int64_t in_degree(NodeID n) override;
+      int64_t out_degree(NodeID n) override;
+};
+
+#endif  // ADLISTCOMPRESSED_H_
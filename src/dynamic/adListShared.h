@@ -41,9 +41,8 @@ class adListShared: public dataStruc {
 template <typename T>
 adListShared<T>::adListShared(bool w, bool d, int64_t _num_nodes): dataStruc(w, d), num_nodes_initialize(_num_nodes){    
 
-    // initialize 1) property 2) affected 3) vertices vectors 4) mutex
-    property.resize(num_nodes_initialize, -1);    
-    affected.resize(num_nodes_initialize); affected.fill(false);
+    // initialize 1) affected 2) vertices vectors 3) mutex
+    affected.resize(num_nodes_initialize);
    
     out_neighbors.resize(num_nodes_initialize);    
     in_neighbors.resize(num_nodes_initialize);
@@ -64,21 +63,7 @@ void adListShared<T>::processMetaData(const Edge& e, bool source) {
     if(source) exists = e.sourceExists;
     else exists = e.destExists;
 
-    // using CAS operations implemented in GAP 
-    if(source){
-        NodeID v = e.source;
-        bool aff = affected[v];
-        if(!aff){
-            compare_and_swap(affected[v], aff, true);
-        }
-    }
-    else{
-        NodeID v = e.destination;
-        bool aff = affected[v];
-        if(!aff){
-            compare_and_swap(affected[v], aff, true);
-        }
-    }
+    affected.insert(source ? e.source : e.destination);
     
     if(exists){       
         stinger_int64_fetch_add(&num_edges, 1);                 
@@ -205,10 +190,18 @@ int64_t adListShared<T>::out_degree(NodeID n)
 template <typename T>
 void adListShared<T>::print()
 {
+    // neighbor storage, comparable with adListCompressed's bytesPerEdge
+    int64_t stored = 0;
+    size_t bytes = 0;
+    for (NodeID n = 0; n < num_nodes_initialize; n++) {
+        stored += out_neighbors[n].size() + in_neighbors[n].size();
+        bytes += (out_neighbors[n].capacity() + in_neighbors[n].capacity()) * sizeof(T);
+    }
     std::cout << " numNodes: " << num_nodes << 
             " numEdges: " << num_edges << 
             " weighted: " << weighted << 
             " directed: " << directed << 
+            " bytesPerEdge: " << (stored ? double(bytes) / stored : 0) << 
 	std::endl;
 
     /*cout << "Property: "; printVector(property);    
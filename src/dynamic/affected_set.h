@@ -0,0 +1,56 @@
+#ifndef AFFECTED_SET_H_
+#define AFFECTED_SET_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "types.h"
+
+/* Vertices touched by the current batch.
+
+   An atomic bitmap deduplicates insertions and a dense list records every
+   vertex once, in insertion order. Incremental algorithms iterate the list
+   instead of scanning all vertices, and clear() only resets the bits of
+   listed vertices, so both cost O(affected) rather than O(num_nodes).
+   insert() and contains() are thread-safe; resize() and clear() are not. */
+
+class affected_set {
+    std::vector<uint64_t> bits;
+    std::vector<NodeID> list;   // sized to the vertex count, filled up to count
+    int64_t count = 0;
+
+public:
+    // grows the set to n vertices, keeping its contents
+    void resize(int64_t n) {
+        bits.resize((n + 63) / 64, 0);
+        list.resize(n);
+    }
+
+    // returns true if v was not in the set yet
+    bool insert(NodeID v) {
+        uint64_t mask = uint64_t(1) << (v & 63);
+        if (bits[v >> 6] & mask)
+            return false;
+        if (__sync_fetch_and_or(&bits[v >> 6], mask) & mask)
+            return false;
+        list[__sync_fetch_and_add(&count, 1)] = v;
+        return true;
+    }
+
+    bool contains(NodeID v) const {
+        return (bits[v >> 6] >> (v & 63)) & 1;
+    }
+
+    void clear() {
+        #pragma omp parallel for
+        for (int64_t i = 0; i < count; i++)
+            bits[list[i] >> 6] = 0;
+        count = 0;
+    }
+
+    int64_t size() const { return count; }
+    const NodeID* begin() const { return list.data(); }
+    const NodeID* end() const { return list.data() + count; }
+};
+
+#endif  // AFFECTED_SET_H_
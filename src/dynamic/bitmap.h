@@ -0,0 +1,52 @@
+#ifndef BITMAP_H_
+#define BITMAP_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/* This implementation has been borrowed from GAP Benchmark Suite (https://github.com/sbeamer/gapbs)
+   and modified for SAGA-Bench: it can grow with the graph. */
+
+// One bit per vertex, e.g. a BFS frontier for bottom-up steps.
+// set_bit() is only safe if each 64-bit word is written by one thread.
+class Bitmap {
+ public:
+  explicit Bitmap(size_t size = 0) {
+    resize(size);
+  }
+
+  // grows to size bits, keeping the current ones
+  void resize(size_t size) {
+    if (words.size() < (size + kBitsPerWord - 1) / kBitsPerWord)
+      words.resize((size + kBitsPerWord - 1) / kBitsPerWord, 0);
+  }
+
+  void reset() {
+    std::fill(words.begin(), words.end(), 0);
+  }
+
+  void set_bit(size_t pos) {
+    words[word_offset(pos)] |= uint64_t(1) << bit_offset(pos);
+  }
+
+  void set_bit_atomic(size_t pos) {
+    __sync_fetch_and_or(&words[word_offset(pos)], uint64_t(1) << bit_offset(pos));
+  }
+
+  bool get_bit(size_t pos) const {
+    return (words[word_offset(pos)] >> bit_offset(pos)) & 1;
+  }
+
+  void swap(Bitmap &other) {
+    words.swap(other.words);
+  }
+
+ private:
+  std::vector<uint64_t> words;
+  static const size_t kBitsPerWord = 64;
+  static size_t word_offset(size_t n) { return n / kBitsPerWord; }
+  static size_t bit_offset(size_t n) { return n & (kBitsPerWord - 1); }
+};
+
+#endif  // BITMAP_H_
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <memory>
 
 #include "topAlg.h"
 #include "topDataStruc.h"
@@ -12,11 +13,25 @@ void* dequeAndInsertEdge(
 		dataStruc *ds,
     EdgeBatchQueue *q,
     std::mutex *q_lock,
-    std::string algorithm,
+    std::vector<std::string> algorithms,
+    bool csr_snapshot,
+    int ppr_top_k,
     bool *still_reading)
 {	
 	//std::cout << "Thread dequeAndInsertEdge: on CPU " << sched_getcpu() << "\n";
-    Algorithm alg(algorithm, ds, dtype);
+    // one Algorithm per -a entry, each with its own property array and workspace
+    std::vector<std::unique_ptr<Algorithm>> algs;
+    for (const std::string &algorithm : algorithms)
+	algs.emplace_back(new Algorithm(algorithm, ds, dtype));
+    // optional CSR copy for the from-scratch algorithms, rebuilt after every update
+    std::unique_ptr<dataStruc> snapshot;
+    for (auto &alg : algs) {
+	if (csr_snapshot && alg->fromScratch()) {
+	    if (!snapshot)
+		snapshot.reset(createSnapshot(ds));
+	    alg->setSnapshot(snapshot.get());
+	}
+    }
     int batch = 0;
     EdgeList el;
     q_lock->lock();
@@ -28,14 +43,26 @@ void* dequeAndInsertEdge(
 		Timer t;
 		t.Start();
 		ds->update(el);	
+		ds->sync_degrees();
 		
 		t.Stop();    
         ofstream out("Update.csv", std::ios_base::app);   
         out << t.Seconds() << std::endl;    
         out.close();	
+		if (snapshot) {
+		    t.Start();
+		    snapshotGraph(ds, snapshot.get());
+		    t.Stop();
+		    ofstream snap_out("Snapshot.csv", std::ios_base::app);
+		    snap_out << t.Seconds() << std::endl;
+		    snap_out.close();
+		}
 	    std::cout << "Updated Batch: " << batch << std::endl;
 	    batch++;
-	    alg.performAlg();
+	    for (auto &alg : algs)
+		alg->performAlg(el);
+	    // every algorithm has seen this batch's affected vertices
+	    ds->affected.clear();
 	} else {		
 	    q_lock->unlock();		
 	    std::this_thread::sleep_for(std::chrono::milliseconds(1));		
@@ -43,6 +70,11 @@ void* dequeAndInsertEdge(
 	q_lock->lock();
     }
     q_lock->unlock();
+
+    if (ppr_top_k > 0) {
+	for (auto &alg : algs)
+	    alg->printTopPPR(ppr_top_k);
+    }
     
     // ##################### CORRECTNESS CHECK ############################
     // LJ: batch == 138
@@ -53,31 +85,31 @@ void* dequeAndInsertEdge(
 
     /*for (int64_t i = 0; i < ds->num_nodes; ++i) {
 	std::cout << "Property[" << i << "] = "
-		  << ds->property[i] << std::endl;
+		  << algs[0]->property(i) << std::endl;
     }*/
 
-    /*if ((algorithm == "prdyn") && (dtype == "adListChunked")) {
+    /*if ((algorithms[0] == "prdyn") && (dtype == "adListChunked")) {
 	ofstream out("PRDynAdListOrkut.csv"); 
 	for(int64_t i =0; i < ds->num_nodes; i++){
-	    out << ds->property[i] << endl;
+	    out << algs[0]->property(i) << endl;
 	}                       
 	out.close(); 
-    } else if ((algorithm == "prfromscratch") && (dtype == "adListChunked")) {
+    } else if ((algorithms[0] == "prfromscratch") && (dtype == "adListChunked")) {
 	ofstream out("PRStatAdListOrkut.csv"); 
 	for(int64_t i =0; i < ds->num_nodes; i++){
-	    out << ds->property[i] << endl;
+	    out << algs[0]->property(i) << endl;
 	}                       
 	out.close();
-    } else if ((algorithm == "prdyn") && (dtype == "degAwareRHH")) {
+    } else if ((algorithms[0] == "prdyn") && (dtype == "degAwareRHH")) {
 	ofstream out("PRDynDarhhOrkut.csv"); 
 	for(int64_t i =0; i < ds->num_nodes; i++){
-	    out << ds->property[i] << endl;
+	    out << algs[0]->property(i) << endl;
 	}                       
 	out.close();
-    } else if ((algorithm == "prfromscratch") && (dtype == "degAwareRHH")) {
+    } else if ((algorithms[0] == "prfromscratch") && (dtype == "degAwareRHH")) {
 	ofstream out("PRStatDarhhOrkut.csv");
 	for(int64_t i =0; i < ds->num_nodes; i++){
-	    out << ds->property[i] << endl;
+	    out << algs[0]->property(i) << endl;
 	}                       
 	out.close();
     }*/
@@ -2,6 +2,8 @@
 #define BUILDER_H
 
 #include <mutex>
+#include <string>
+#include <vector>
 
 #include "types.h"
 #include "abstract_data_struc.h"
@@ -11,7 +13,9 @@ void* dequeAndInsertEdge(
     dataStruc *ds,
     EdgeBatchQueue *q,
     std::mutex *lock,
-    std::string alg,
+    std::vector<std::string> algs,
+    bool csr_snapshot,
+    int ppr_top_k,
     bool *loop);
 
 #endif
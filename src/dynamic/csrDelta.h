@@ -0,0 +1,337 @@
+#ifndef CSRDELTA_H_
+#define CSRDELTA_H_
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "abstract_data_struc.h"
+#include "stinger_atomics.h"
+#include "print.h"
+
+/* CSR base + per-batch delta log (LLAMA/GraphOne style).
+
+   The bulk of the edges lives in an immutable CSR with neighbor lists sorted
+   by ID. Every batch appends one delta segment holding only the edges that
+   were new in that batch, grouped by source vertex, and every vertex keeps
+   the [begin, end) ranges it owns in the segments written since the last
+   compaction. Weights of edges that already exist are overwritten in place.
+
+   Once there are too many segments, or they hold too many edges relative to
+   the base, a background thread merges base and segments into a new CSR
+   while the algorithm runs on the current one. The merged CSR is installed
+   at the start of the next update, so readers never see it change. */
+
+bool compare_and_swap(bool &x, const bool &old_val, const bool &new_val);
+
+template <typename T>
+struct csr_snapshot {
+    std::vector<int64_t> offsets;   // num_nodes + 1 entries
+    std::vector<T> neighbors;
+};
+
+template <typename T>
+struct delta_range {
+    T* begin;
+    T* end;
+};
+
+// one direction (out or in) of the graph
+template <typename T>
+class csr_delta_store {
+public:
+    std::unique_ptr<csr_snapshot<T>> base;
+    std::unique_ptr<csr_snapshot<T>> pending;              // built by the compactor
+    std::vector<std::vector<T>> segments;                  // delta log, one per batch
+    std::vector<std::vector<delta_range<T>>> ranges;       // per vertex, into segments
+    std::vector<int64_t> degree;
+    int64_t delta_edges = 0;
+
+    explicit csr_delta_store(int64_t n);
+    void insert_batch(std::vector<std::pair<NodeID, T>> &edges);
+    void compact();
+    void install();
+    int64_t base_edges() const { return base->neighbors.size(); }
+};
+
+template <typename T>
+csr_delta_store<T>::csr_delta_store(int64_t n):
+    base(new csr_snapshot<T>()),
+    ranges(n),
+    degree(n, 0)
+{
+    base->offsets.resize(n + 1, 0);
+}
+
+/* Merge the batch into the store. Each source vertex is handled by exactly one
+   thread, so the base slice, ranges and degree of a vertex are never shared. */
+template <typename T>
+void csr_delta_store<T>::insert_batch(std::vector<std::pair<NodeID, T>> &edges)
+{
+    auto by_key = [](const std::pair<NodeID, T> &a, const std::pair<NodeID, T> &b) {
+        return a.first != b.first ? a.first < b.first
+                                  : a.second.getNodeID() < b.second.getNodeID();
+    };
+    // stable, so the last copy of a duplicate edge is the latest one
+    std::stable_sort(edges.begin(), edges.end(), by_key);
+
+    std::vector<size_t> group_start;
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (i == 0 || edges[i].first != edges[i - 1].first)
+            group_start.push_back(i);
+    }
+    int64_t num_groups = group_start.size();
+    group_start.push_back(edges.size());
+
+    std::vector<char> is_new(edges.size(), 0);
+    std::vector<int64_t> group_new(num_groups + 1, 0);
+    auto by_id = [](const T &a, const T &b) { return a.getNodeID() < b.getNodeID(); };
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int64_t g = 0; g < num_groups; g++) {
+        NodeID u = edges[group_start[g]].first;
+        T* first = base->neighbors.data() + base->offsets[u];
+        T* last = base->neighbors.data() + base->offsets[u + 1];
+        for (size_t i = group_start[g]; i < group_start[g + 1]; i++) {
+            const T &nb = edges[i].second;
+            if (i + 1 < group_start[g + 1] &&
+                edges[i + 1].second.getNodeID() == nb.getNodeID())
+                continue;
+            T* it = std::lower_bound(first, last, nb, by_id);
+            if (it != last && it->getNodeID() == nb.getNodeID()) {
+                *it = nb;
+                continue;
+            }
+            bool found = false;
+            for (auto &r : ranges[u]) {
+                for (T* p = r.begin; p != r.end && !found; p++) {
+                    if (p->getNodeID() == nb.getNodeID()) {
+                        *p = nb;
+                        found = true;
+                    }
+                }
+            }
+            if (!found) {
+                is_new[i] = 1;
+                group_new[g + 1]++;
+            }
+        }
+    }
+
+    for (int64_t g = 0; g < num_groups; g++)
+        group_new[g + 1] += group_new[g];
+    int64_t total_new = group_new[num_groups];
+    if (total_new == 0)
+        return;
+
+    segments.emplace_back(total_new);
+    T* seg = segments.back().data();
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int64_t g = 0; g < num_groups; g++) {
+        int64_t count = group_new[g + 1] - group_new[g];
+        if (count == 0)
+            continue;
+        NodeID u = edges[group_start[g]].first;
+        T* out = seg + group_new[g];
+        for (size_t i = group_start[g]; i < group_start[g + 1]; i++) {
+            if (is_new[i])
+                *out++ = edges[i].second;
+        }
+        ranges[u].push_back(delta_range<T>{seg + group_new[g], out});
+        degree[u] += count;
+    }
+    delta_edges += total_new;
+}
+
+/* Build the merged CSR into pending. Only reads the store, so it can run
+   alongside traversals; it must finish before the next insert_batch. */
+template <typename T>
+void csr_delta_store<T>::compact()
+{
+    int64_t n = degree.size();
+    std::unique_ptr<csr_snapshot<T>> merged(new csr_snapshot<T>());
+    merged->offsets.resize(n + 1);
+    merged->offsets[0] = 0;
+    for (int64_t u = 0; u < n; u++)
+        merged->offsets[u + 1] = merged->offsets[u] + degree[u];
+    merged->neighbors.resize(merged->offsets[n]);
+
+    auto by_id = [](const T &a, const T &b) { return a.getNodeID() < b.getNodeID(); };
+    for (int64_t u = 0; u < n; u++) {
+        T* out = merged->neighbors.data() + merged->offsets[u];
+        T* first = out;
+        out = std::copy(base->neighbors.data() + base->offsets[u],
+                        base->neighbors.data() + base->offsets[u + 1], out);
+        bool had_base = out != first;
+        for (auto &r : ranges[u])
+            out = std::copy(r.begin, r.end, out);
+        if (!ranges[u].empty()) {
+            if (had_base && ranges[u].size() == 1)
+                std::inplace_merge(first, first + (base->offsets[u + 1] - base->offsets[u]), out, by_id);
+            else
+                std::sort(first, out, by_id);
+        }
+    }
+    pending = std::move(merged);
+}
+
+template <typename T>
+void csr_delta_store<T>::install()
+{
+    if (!pending)
+        return;
+    base = std::move(pending);
+    segments.clear();
+    for (auto &r : ranges)
+        r.clear();
+    delta_edges = 0;
+}
+
+template <typename T>
+class csrDelta: public dataStruc {
+    private:
+      int64_t num_nodes_initialize;
+      const size_t max_segments;        // compact after this many delta segments ...
+      const float max_delta_ratio;      // ... or once deltas exceed this share of the base
+      std::thread compactor;
+      int64_t num_compactions = 0;
+
+      void processMetaData(const Edge& e, bool source);
+      bool needs_compaction(const csr_delta_store<T> &s) const;
+      void finish_compaction();
+
+    public:
+      csr_delta_store<T> out;
+      csr_delta_store<T> in;    // only filled for directed graphs
+      csrDelta(bool w, bool d, int64_t _num_nodes,
+               size_t _max_segments = 8, float _max_delta_ratio = 0.25);
+      ~csrDelta();
+      void update(const EdgeList& el) override;
+      void print() override;
+      int64_t in_degree(NodeID n) override;
+      int64_t out_degree(NodeID n) override;
+};
+
+template <typename T>
+csrDelta<T>::csrDelta(bool w, bool d, int64_t _num_nodes, size_t _max_segments, float _max_delta_ratio):
+    dataStruc(w, d),
+    num_nodes_initialize(_num_nodes),
+    max_segments(_max_segments),
+    max_delta_ratio(_max_delta_ratio),
+    out(_num_nodes),
+    in(d ? _num_nodes : 0)
+{
+    affected.resize(num_nodes_initialize);
+}
+
+template <typename T>
+csrDelta<T>::~csrDelta()
+{
+    if (compactor.joinable())
+        compactor.join();
+}
+
+template <typename T>
+void csrDelta<T>::processMetaData(const Edge& e, bool source)
+{
+    bool exists = source ? e.sourceExists : e.destExists;
+    NodeID v = source ? e.source : e.destination;
+
+    affected.insert(v);
+
+    if (!exists)
+        stinger_int64_fetch_add(&num_nodes, 1);
+    stinger_int64_fetch_add(&num_edges, 1);
+}
+
+template <typename T>
+bool csrDelta<T>::needs_compaction(const csr_delta_store<T> &s) const
+{
+    return s.segments.size() >= max_segments ||
+           s.delta_edges > max_delta_ratio * s.base_edges();
+}
+
+template <typename T>
+void csrDelta<T>::finish_compaction()
+{
+    if (!compactor.joinable())
+        return;
+    compactor.join();
+    out.install();
+    if (directed)
+        in.install();
+    num_compactions++;
+}
+
+template <typename T>
+void csrDelta<T>::update(const EdgeList& el)
+{
+    finish_compaction();
+
+    #pragma omp parallel for
+    for (unsigned int k = 0; k < el.size(); k++) {
+        processMetaData(el[k], true);
+        processMetaData(el[k], false);
+    }
+
+    std::vector<std::pair<NodeID, T>> out_edges, in_edges;
+    out_edges.reserve(directed ? el.size() : 2 * el.size());
+    if (directed)
+        in_edges.reserve(el.size());
+    for (const Edge &e : el) {
+        T nb;
+        nb.setInfo(e.destination, e.weight);
+        out_edges.emplace_back(e.source, nb);
+        nb.setInfo(e.source, e.weight);
+        if (directed)
+            in_edges.emplace_back(e.destination, nb);
+        else
+            out_edges.emplace_back(e.destination, nb);
+    }
+    out.insert_batch(out_edges);
+    if (directed)
+        in.insert_batch(in_edges);
+
+    if (needs_compaction(out) || (directed && needs_compaction(in))) {
+        compactor = std::thread([this]() {
+            out.compact();
+            if (directed)
+                in.compact();
+        });
+    }
+}
+
+template <typename T>
+int64_t csrDelta<T>::in_degree(NodeID n)
+{
+    if (directed)
+        return in.degree[n];
+    else
+        return out.degree[n];
+}
+
+template <typename T>
+int64_t csrDelta<T>::out_degree(NodeID n)
+{
+    return out.degree[n];
+}
+
+template <typename T>
+void csrDelta<T>::print()
+{
+    std::cout << " numNodes: " << num_nodes <<
+            " numEdges: " << num_edges <<
+            " weighted: " << weighted <<
+            " directed: " << directed <<
+            " baseEdges: " << out.base_edges() <<
+            " deltaEdges: " << out.delta_edges <<
+            " deltaSegments: " << out.segments.size() <<
+            " compactions: " << num_compactions <<
+    std::endl;
+}
+
+#endif  // CSRDELTA_H_
@@ -0,0 +1,63 @@
+#ifndef CSRGRAPH_H_
+#define CSRGRAPH_H_
+
+#include <iostream>
+#include <vector>
+
+#include "abstract_data_struc.h"
+#include "csrDelta.h"
+
+/* Read-only CSR (and, for directed graphs, CSC) snapshot of another data
+   structure.
+
+   The from-scratch algorithms sweep every neighbor list several times per
+   batch (PR up to ten times). On a snapshot those sweeps read contiguous
+   arrays instead of walking stinger block chains, darhh probe sequences or
+   chunk indirections. It is never updated in place: snapshotGraph() in
+   snapshot.h rebuilds it from the live structure after each update. */
+
+template <typename T>
+class csrGraph: public dataStruc {
+    public:
+      csr_snapshot<T> out;
+      csr_snapshot<T> in;       // only filled for directed graphs
+      csrGraph(bool w, bool d): dataStruc(w, d) {}
+      void update(const EdgeList& el) override;
+      void print() override;
+      int64_t in_degree(NodeID n) override;
+      int64_t out_degree(NodeID n) override;
+};
+
+template <typename T>
+void csrGraph<T>::update(const EdgeList& el)
+{
+    (void)el;
+    std::cout << "csrGraph is a read-only snapshot, rebuild it instead" << std::endl;
+    exit(-1);
+}
+
+template <typename T>
+int64_t csrGraph<T>::in_degree(NodeID n)
+{
+    const csr_snapshot<T> &s = directed ? in : out;
+    return s.offsets[n + 1] - s.offsets[n];
+}
+
+template <typename T>
+int64_t csrGraph<T>::out_degree(NodeID n)
+{
+    return out.offsets[n + 1] - out.offsets[n];
+}
+
+template <typename T>
+void csrGraph<T>::print()
+{
+    std::cout << " numNodes: " << num_nodes <<
+            " numEdges: " << num_edges <<
+            " weighted: " << weighted <<
+            " directed: " << directed <<
+            " snapshotEdges: " << out.neighbors.size() <<
+    std::endl;
+}
+
+#endif  // CSRGRAPH_H_
@@ -31,11 +31,20 @@ private:
 	friend neighborhood_iter<darhh<T>>;
     private:
 	void transfer_low_to_high(NodeID const &n);
+	void transfer_high_to_low(NodeID const &n);
 	void insert(Edge const &e);
+	inline void count_degree(uint32_t old_deg, uint32_t new_deg);
+	void tune_threshold();
+	void migrate();
 	std::queue<Edge> q;
 	std::mutex q_mutex;
+	// Sources that gained an edge during the current batch.
+	std::vector<NodeID> touched;
+	// degree_hist[d] = # vertices of degree d; the last bucket holds the rest.
+	std::vector<uint64_t> degree_hist;
+	uint32_t ld_threshold;
     public:
-	partition(darhh* parent);
+	partition(darhh* parent, uint32_t ld_threshold);
 	partition() = delete;
 	~partition();
 	inline void enqueue(Edge const &e);
@@ -45,14 +54,18 @@ private:
     };
     static void dequeue_loop(partition *pt, volatile bool& done);
     inline int32_t pt_hash(NodeID const &n) const;
-    static const int8_t ld_threshold = 2;
+    static const uint32_t default_ld_threshold = 2;
+    static const uint32_t max_ld_threshold = 16;
+    // Auto-tuning keeps this share of a partition's vertices in ld_rhh.
+    static constexpr float ld_vertex_share = 0.9;
+    const bool auto_ld_threshold;
     const int64_t init_num_nodes;
     const int64_t num_out_partitions;
     const int64_t num_in_partitions;
     std::vector<std::unique_ptr<partition>> in, out;
     std::mutex affected_mutex, num_nodes_mutex;
 public:
-    darhh(bool w, bool d, int64_t init_nn, int64_t nt);
+    darhh(bool w, bool d, int64_t init_nn, int64_t nt, uint32_t ld_thresh = 0);
     void update(EdgeList const &el) override;
     int64_t out_degree(NodeID n) override;
     int64_t in_degree(NodeID n) override;
@@ -61,7 +74,9 @@ public:
 };
 
 template <typename T>
-darhh<T>::partition::partition(darhh* parent):
+darhh<T>::partition::partition(darhh* parent, uint32_t ld_threshold):
+    degree_hist(max_ld_threshold + 2, 0),
+    ld_threshold(ld_threshold),
     parent(parent)
 {
     ld = new ld_rhh<T>();
@@ -78,36 +93,95 @@ darhh<T>::partition::~partition()
 template <typename T>
 void darhh<T>::partition::transfer_low_to_high(NodeID const &n)
 {
+    // Deleting shifts the probe sequence we are walking, so collect first.
+    std::vector<EdgeID> moved;
     for (auto it = ld->begin(n), end = ld->end(n); it != end; ++it) {
 	EdgeID id(n, it.cursor->getNodeID());
 	hd->insert_elem(id, it.cursor->getWeight());
-	ld->arr[it.pos].mark_deleted();
+	moved.push_back(id);
     }
+    for (auto& id: moved)
+	ld->delete_elem(id);
 }
 
+template <typename T>
+void darhh<T>::partition::transfer_high_to_low(NodeID const &n)
+{
+    for (auto it = hd->begin(n), end = hd->end(n); it != end; ++it)
+	ld->insert_elem(Edge(n, it.cursor->getNodeID(), it.cursor->getWeight()));
+    hd->delete_vertex(n);
+}
+
+template <typename T>
+void darhh<T>::partition::count_degree(uint32_t old_deg, uint32_t new_deg)
+{
+    const uint32_t last = degree_hist.size() - 1;
+    if (old_deg)
+	--degree_hist[std::min(old_deg, last)];
+    if (new_deg)
+	++degree_hist[std::min(new_deg, last)];
+}
+
+/* Vertices stay where they are for the whole batch; migrate() checks the
+   touched ones against ld_threshold once the batch is drained. */
 template <typename T>
 void darhh<T>::partition::insert(Edge const &e)
 {
-    if (!e.sourceExists) {
-	ld->insert_elem(e);
-	//std::lock_guard<std::mutex> guard(parent->num_nodes_mutex);
-	//++parent->super::num_nodes;
-    } else {
-	int deg = ld->get_degree(e.source);
-	if (deg > 0 && deg < ld_threshold) {
-	    ld->insert_elem(e);
-	} else if (deg == ld_threshold) {
-	    transfer_low_to_high(e.source);
-	    hd->insert_elem(e);
-	} else {
-	    if (hd->get_degree(e.source) > 0)
-		hd->insert_elem(e);
-	    else
-		ld->insert_elem(e);
+    uint32_t deg = ld->get_degree(e.source);
+    bool high = false;
+    if (deg == 0) {
+	deg = hd->get_degree(e.source);
+	high = deg > 0;
+    }
+    bool added = high ? hd->insert_elem(e) : ld->insert_elem(e);
+    if (!added)
+	return;
+    count_degree(deg, deg + 1);
+    touched.push_back(e.source);
+}
+
+/* Pick the smallest threshold that keeps ld_vertex_share of the vertices in
+   the shared low-degree table. Skewed partitions keep a small threshold so
+   hubs do not lengthen ld probe sequences; flat partitions raise it so that
+   mid-degree vertices do not each pay for a private hd edge chunk.
+   Only the degree histogram is read; vertices left on the wrong side of a
+   new threshold move the next time they gain an edge. */
+template <typename T>
+void darhh<T>::partition::tune_threshold()
+{
+    uint64_t total = 0;
+    for (auto c: degree_hist)
+	total += c;
+    if (total == 0)
+	return;
+    uint64_t covered = 0;
+    uint32_t d = 1;
+    for (; d <= max_ld_threshold; ++d) {
+	covered += degree_hist[d];
+	if (covered >= ld_vertex_share * total)
+	    break;
+    }
+    ld_threshold = std::max(default_ld_threshold, std::min(d, max_ld_threshold));
+}
+
+template <typename T>
+void darhh<T>::partition::migrate()
+{
+    if (parent->auto_ld_threshold)
+	tune_threshold();
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (auto n: touched) {
+	uint32_t deg = ld->get_degree(n);
+	if (deg > ld_threshold) {
+	    transfer_low_to_high(n);
+	} else if (deg == 0) {
+	    deg = hd->get_degree(n);
+	    if (deg > 0 && deg <= ld_threshold)
+		transfer_high_to_low(n);
 	}
     }
-    //std::lock_guard<std::mutex> guard(parent->affected_mutex);
-    //parent->super::affected[e.source] = 1;
+    touched.clear();
 }
 
 template <typename T>
@@ -118,20 +192,21 @@ void darhh<T>::partition::enqueue(Edge const &e)
 }
 
 template <typename T>
-darhh<T>::darhh(bool w, bool d, int64_t init_nn, int64_t nt):
+darhh<T>::darhh(bool w, bool d, int64_t init_nn, int64_t nt, uint32_t ld_thresh):
     super(w, d),
+    auto_ld_threshold(ld_thresh == 0),
     init_num_nodes(init_nn),
     num_out_partitions(d ? nt / 2 : nt),
     num_in_partitions(d ? nt / 2 : 0)
 {
-    super::property.resize(init_num_nodes, -1);
     super::affected.resize(init_num_nodes);
-    super::affected.fill(false);
     for (int i = 0; i < num_out_partitions; ++i) {
-	out.push_back(std::unique_ptr<partition>(new partition(this)));
+	out.push_back(std::unique_ptr<partition>(
+	    new partition(this, ld_thresh ? ld_thresh : default_ld_threshold)));
     }
     for (int i = 0; i < num_in_partitions; ++i) {
-	in.push_back(std::unique_ptr<partition>(new partition(this)));
+	in.push_back(std::unique_ptr<partition>(
+	    new partition(this, ld_thresh ? ld_thresh : default_ld_threshold)));
     }
 }
 
@@ -154,6 +229,8 @@ void darhh<T>::dequeue_loop(partition *pt, volatile bool &done)
 	pt->q_mutex.lock();
     }
     pt->q_mutex.unlock();
+    // Batch drained: move vertices across the ld/hd boundary in one go.
+    pt->migrate();
 }
 
 template <typename T>
@@ -213,8 +290,8 @@ void darhh<T>::update(EdgeList const &el)
 
     int o_ix, i_ix;
     for (auto& e: el) {
-        affected[e.source] = true;
-        affected[e.destination] = true;
+        affected.insert(e.source);
+        affected.insert(e.destination);
         if (!e.sourceExists) num_nodes++;
         if (!e.destExists) num_nodes++;
 	o_ix = pt_hash(e.source);
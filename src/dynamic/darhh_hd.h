@@ -15,12 +15,14 @@ template <typename T> class neighborhood;
 
 template <typename T>
 class hd_rhh {
+    friend class darhh<T>;
     friend class neighborhood_iter<darhh<T>>;
 private:
     using hashmap = std::unordered_map<NodeID, std::unique_ptr<rhh<NodeID, T>>>;
     using edge_chunk = rhh<NodeID, T>;
     class iter {
 	friend class hd_rhh;
+	friend class darhh<T>;
 	friend class neighborhood<darhh<T>>;
 	friend class neighborhood_iter<darhh<T>>;
     private:
@@ -45,9 +47,10 @@ public:
 	load_factor(ec_load_factor) {}
     hd_rhh(uint32_t ec_cap): hd_rhh(ec_cap, 0.9) {}
     hd_rhh(): hd_rhh(pow(2, 5)) {}
-    void insert_elem(Edge edge);
-    void insert_elem(EdgeID id, Weight w);
+    bool insert_elem(Edge edge);
+    bool insert_elem(EdgeID id, Weight w);
     bool delete_elem(EdgeID const &edge);
+    void delete_vertex(NodeID const &id);
     inline uint32_t get_degree(NodeID const &id) const;
     iter begin(NodeID const &id) const;
     iter end(NodeID const &id) const;
@@ -82,9 +85,7 @@ void hd_rhh<T>::iter::operator++()
 	cursor = nullptr;
 	return;
     }
-    while (ec->arr[pos].empty() ||
-	   ec->arr[pos].deleted())
-    {
+    while (ec->arr[pos].empty()) {
 	if (++pos >= ec->get_capacity()) {
 	    cursor = nullptr;
 	    return;
@@ -94,13 +95,13 @@ void hd_rhh<T>::iter::operator++()
 }
 
 template <typename T>
-void hd_rhh<T>::insert_elem(Edge edge)
+bool hd_rhh<T>::insert_elem(Edge edge)
 {
-    insert_elem(EdgeID(edge.source, edge.destination), edge.weight); 
+    return insert_elem(EdgeID(edge.source, edge.destination), edge.weight); 
 }
 
 template <typename T>
-void hd_rhh<T>::insert_elem(EdgeID id, Weight w)
+bool hd_rhh<T>::insert_elem(EdgeID id, Weight w)
 {
     T node;
     node.setInfo(id.second, w);
@@ -112,7 +113,7 @@ void hd_rhh<T>::insert_elem(EdgeID id, Weight w)
     } else {
 	ec = ret->second.get();
     }
-    ec->insert_elem(id.second, node);
+    return ec->insert_elem(id.second, node);
 }
 
 template <typename T>
@@ -125,6 +126,12 @@ bool hd_rhh<T>::delete_elem(EdgeID const &id)
 	return ret->second->delete_elem(id.second);
 }
 
+template <typename T>
+void hd_rhh<T>::delete_vertex(NodeID const &id)
+{
+    v_table.erase(id);
+}
+
 template <typename T>
 uint32_t hd_rhh<T>::get_degree(NodeID const &id) const
 {
@@ -146,8 +153,7 @@ typename hd_rhh<T>::iter hd_rhh<T>::begin(NodeID const &id) const
 	it.cursor = nullptr;
     } else {
 	it.ec = ret->second.get();
-	if (it.ec->arr[it.pos].empty() ||
-	    it.ec->arr[it.pos].deleted())
+	if (it.ec->arr[it.pos].empty())
 	    ++it;
 	else
 	    it.cursor = &(it.ec->arr[it.pos].val);
@@ -47,7 +47,7 @@ public:
     ld_rhh(int cap, float rehash): rhh<EdgeID, T>(cap, rehash) {}
     ld_rhh(int cap): ld_rhh(cap, 0.9) {}
     ld_rhh(): ld_rhh(pow(2, 20), 0.9) {}
-    void insert_elem(Edge const &edge);
+    bool insert_elem(Edge const &edge);
     uint32_t get_degree(NodeID const &id) const;
     iter begin(NodeID id);
     iter end(NodeID id);
@@ -90,7 +90,7 @@ void ld_rhh<T>::iter::operator++()
 	{
 	    cursor = nullptr;
 	    break;
-	} else if (elem.key.first == src && !elem.deleted()) {
+	} else if (elem.key.first == src) {
 	    cursor = &(parent->arr[pos].val);
 	    break;
 	}
@@ -98,12 +98,12 @@ void ld_rhh<T>::iter::operator++()
 }
 
 template <typename T>
-void ld_rhh<T>::insert_elem(Edge const &edge)
+bool ld_rhh<T>::insert_elem(Edge const &edge)
 {
     EdgeID id = EdgeID(edge.source, edge.destination);
     T node;
     node.setInfo(edge.destination, edge.weight);
-    super::insert_elem(id, node);
+    return super::insert_elem(id, node);
 }
 
 template <typename T>
@@ -119,7 +119,7 @@ uint32_t ld_rhh<T>::get_degree(NodeID const &id) const
 	    break;
 	else if (d > super::probe_dist(super::desired_pos(elem.hash), pos))
 	    break;
-	else if (elem.key.first == id && !elem.deleted())
+	else if (elem.key.first == id)
 	    ++count;
     }
     return count;
@@ -135,7 +135,7 @@ typename ld_rhh<T>::iter ld_rhh<T>::begin(NodeID id)
     auto elem = this->arr[it.pos];
     if (elem.empty())
 	it.cursor = nullptr;
-    else if (elem.key.first != id || elem.deleted())
+    else if (elem.key.first != id)
 	++it;
     else
 	it.cursor = &(this->arr[it.pos].val);
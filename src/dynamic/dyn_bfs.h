@@ -6,75 +6,174 @@
 #include "traversal.h"
 #include "../common/timer.h"
 #include "sliding_queue_dynamic.h"
+#include "workspace.h"
+#include "prefetch.h"
+#include "property.h"
+#include "bitmap.h"
 #include "../common/pvector.h"
 
-/* Algorithm: Incremental BFS and BFS starting from scratch */
+/* Algorithm: Incremental BFS and BFS starting from scratch
+
+   Both are direction-optimizing (Beamer et al., as in GAP's bfs.cc): rounds
+   push from a frontier queue while it is small and switch to pulling over
+   in_neigh() with a bitmap frontier once the frontier's outgoing edges
+   exceed 1/alpha of the edges left to check. They switch back when the
+   frontier shrinks below num_nodes/beta. */
+
+typedef int32_t Depth;     // -1 until reached
+
+const int64_t kBFSAlpha = 15;
+const int64_t kBFSBeta = 18;
+
+inline void QueueToBitmap(const SlidingQueue<NodeID>& queue, Bitmap& bm){
+    bm.reset();
+    #pragma omp parallel for
+    for(auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++)
+        bm.set_bit_atomic(*q_iter);
+}
+
+inline void BitmapToQueue(int64_t num_nodes, const Bitmap& bm, SlidingQueue<NodeID>& queue){
+    #pragma omp parallel
+    {
+        QueueBuffer<NodeID> lqueue(queue);
+        #pragma omp for
+        for(NodeID n = 0; n < num_nodes; n++){
+            if(bm.get_bit(n))
+                lqueue.push_back(n);
+        }
+        lqueue.flush();
+    }
+    queue.slide_window();
+}
+
+// outgoing edges of the frontier, used to pick the direction of the next round
+template<typename T>
+int64_t BFSFrontierEdges(T* ds, const SlidingQueue<NodeID>& queue){
+    degree_view deg = ds->degrees();
+    int64_t edges = 0;
+    #pragma omp parallel for reduction(+ : edges)
+    for(auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++)
+        edges += deg.out_degree(*q_iter);
+    return edges;
+}
+
+// Pull round: every vertex that can still improve looks for frontier vertices
+// among its in-neighbors. min_depth is a lower bound on the frontier depths,
+// so a vertex stops at the first in-neighbor that gives it min_depth + 1.
+// Returns the number of vertices in next.
+template<typename T>
+int64_t BFSBottomUpStep(T* ds, vertex_property<Depth>& depth, const Bitmap& front, Bitmap& next, Depth min_depth){
+    Depth best_depth = min_depth + 1;
+    int64_t awake_count = 0;
+    next.reset();
+    // chunks are multiples of 64 so each bitmap word has a single writer
+    #pragma omp parallel for reduction(+ : awake_count) schedule(dynamic, 1024)
+    for(NodeID u = 0; u < ds->num_nodes; u++){
+        Depth old_depth = depth[u];
+        if((old_depth != -1) && (old_depth <= best_depth))
+            continue;
+        Depth new_depth = old_depth;
+        for(auto v: in_neigh(u, ds)){
+            if(front.get_bit(v)){
+                Depth candidate = depth[v] + 1;
+                if((new_depth == -1) || (candidate < new_depth)){
+                    new_depth = candidate;
+                    if(new_depth == best_depth)
+                        break;
+                }
+            }
+        }
+        if(new_depth != old_depth){
+            depth[u] = new_depth;
+            next.set_bit(u);
+            awake_count++;
+        }
+    }
+    return awake_count;
+}
+
+// runs pull rounds while the frontier stays large, then hands it back as a queue;
+// returns the lower bound on the depths of that frontier
+template<typename T>
+Depth BFSBottomUpRounds(T* ds, vertex_property<Depth>& depth, SlidingQueue<NodeID>& queue,
+                       Bitmap& front, Bitmap& next, Depth min_depth){
+    front.resize(ds->num_nodes);
+    next.resize(ds->num_nodes);
+    QueueToBitmap(queue, front);
+    int64_t awake_count = queue.size();
+    int64_t old_awake_count;
+    do {
+        old_awake_count = awake_count;
+        awake_count = BFSBottomUpStep(ds, depth, front, next, min_depth);
+        front.swap(next);
+        min_depth++;
+    } while((awake_count >= old_awake_count) || (awake_count > ds->num_nodes / kBFSBeta));
+    BitmapToQueue(ds->num_nodes, front, queue);
+    return min_depth;
+}
 
 template<typename T> 
-void BFSIter0(T* ds, SlidingQueue<NodeID>& queue){  
-    pvector<bool> visited(ds->num_nodes, false);     
+void BFSIter0(T* ds, vertex_property<Depth>& depth, SlidingQueue<NodeID>& queue, algo_workspace& ws){  
+    epoch_set& visited = ws.visited;
+    visited.reset(ds->num_nodes);
   
     #pragma omp parallel     
     {
         QueueBuffer<NodeID> lqueue(queue);
         #pragma omp for schedule(dynamic, 64)
-        for(NodeID n=0; n < ds->num_nodes; n++){
-            if(ds->affected[n]){
-                float old_depth = ds->property[n];
-                float new_depth = std::numeric_limits<float>::max();
-
-                // pull new depth from incoming neighbors
-                for(auto v: in_neigh(n, ds)){
-                    if (ds->property[v] != -1) {
-                        new_depth = std::min(new_depth, ds->property[v] + 1);
-                    }
-                }                                         
-                
-                // trigger happens if it is:
-                // 1) brand new vertex with old_prop = -1 and we found a new valid min depth 
-                // 2) already existing vertex and we found a new depth smaller than old depth 
-                bool trigger = (
-                ((new_depth < old_depth) || (old_depth == -1)) 
-                && (new_depth != std::numeric_limits<float>::max())                 
-                );               
-
-                /*if(trigger){                                                 
-                    ds->property[n] = new_depth; 
-                    for(auto v: out_neigh(n, dataStruc, ds, directed)){
-                        float curr_depth = ds->property[v];
-                        float updated_depth = ds->property[n] + 1;                        
-                        if((updated_depth < curr_depth) || (curr_depth == -1)){   
-                            if(compare_and_swap(ds->property[v], curr_depth, updated_depth)){                                                              
-                                lqueue.push_back(v); 
-                            }
+        for(auto a_iter = ds->affected.begin(); a_iter < ds->affected.end(); a_iter++){
+            NodeID n = *a_iter;
+            Depth old_depth = depth[n];
+            Depth new_depth = std::numeric_limits<Depth>::max();
+
+            // pull new depth from incoming neighbors
+            for(auto v: in_neigh(n, ds)){
+                if (depth[v] != -1) {
+                    new_depth = std::min(new_depth, depth[v] + 1);
+                }
+            }                                         
+            
+            // trigger happens if it is:
+            // 1) brand new vertex with old_prop = -1 and we found a new valid min depth 
+            // 2) already existing vertex and we found a new depth smaller than old depth 
+            bool trigger = (
+            ((new_depth < old_depth) || (old_depth == -1)) 
+            && (new_depth != std::numeric_limits<Depth>::max())                 
+            );               
+
+            /*if(trigger){                                                 
+                depth[n] = new_depth; 
+                for(auto v: out_neigh(n, dataStruc, ds, directed)){
+                    Depth curr_depth = depth[v];
+                    Depth updated_depth = depth[n] + 1;                        
+                    if((updated_depth < curr_depth) || (curr_depth == -1)){   
+                        if(compare_and_swap(depth[v], curr_depth, updated_depth)){                                                              
+                            lqueue.push_back(v); 
                         }
                     }
-                }*/
-
-                // Note: above is commented and included this new thing. 
-                // Above was leading to vertices being queued redundantly
-                // Above assumes updated_depth < curr_depth only once. 
-                // This is not true in dynamic case because we start from affected vertices
-                // whose depths are not all necessary the same.
-                // In static version, the above works because static version starts from the source 
-                // and we know that updated_depth < curr_depth only once. 
-
-                if(trigger){
-                    ds->property[n] = new_depth; 
-                    for(auto v: out_neigh(n, ds)){
-                        float curr_depth = ds->property[v];
-                        float updated_depth = ds->property[n] + 1;
-                        if((updated_depth < curr_depth) || (curr_depth == -1)){
-                            bool curr_val = visited[v];
-                            if(!curr_val){
-                                if(compare_and_swap(visited[v], curr_val, true))
-                                    lqueue.push_back(v);
-                            }
-                            while(!compare_and_swap(ds->property[v], curr_depth, updated_depth)){
-                                curr_depth = ds->property[v];
-                                if(curr_depth <= updated_depth){
-                                    break;
-                                }
+                }
+            }*/
+
+            // Note: above is commented and included this new thing. 
+            // Above was leading to vertices being queued redundantly
+            // Above assumes updated_depth < curr_depth only once. 
+            // This is not true in dynamic case because we start from affected vertices
+            // whose depths are not all necessary the same.
+            // In static version, the above works because static version starts from the source 
+            // and we know that updated_depth < curr_depth only once. 
+
+            if(trigger){
+                depth[n] = new_depth; 
+                for(auto v: out_neigh(n, ds)){
+                    Depth curr_depth = depth[v];
+                    Depth updated_depth = depth[n] + 1;
+                    if((updated_depth < curr_depth) || (curr_depth == -1)){
+                        if(visited.insert(v))
+                            lqueue.push_back(v);
+                        while(!compare_and_swap(depth[v], curr_depth, updated_depth)){
+                            curr_depth = depth[v];
+                            if(curr_depth <= updated_depth){
+                                break;
                             }
                         }
                     }
@@ -86,21 +185,37 @@ void BFSIter0(T* ds, SlidingQueue<NodeID>& queue){
 }
 
 template<typename T>
-void dynBFSAlg(T* ds, NodeID source){
+void dynBFSAlg(T* ds, vertex_property<Depth>& depth, NodeID source, algo_workspace& ws){
     std::cout <<"Running dynamic BFS " << std::endl;
     
     Timer t;
     t.Start();
+    depth.resize(ds->num_nodes);
     
-    SlidingQueue<NodeID> queue(ds->num_nodes);         
-    if(ds->property[source] == -1) ds->property[source] = 0;
+    SlidingQueue<NodeID>& queue = ws.frontier(ds->num_nodes);         
+    if(depth[source] == -1) depth[source] = 0;
     
-    BFSIter0(ds, queue);
+    BFSIter0(ds, depth, queue, ws);
     queue.slide_window();   
+    bool pulled = false;
     
     while(!queue.empty()){             
         //std::cout << "Queue not empty, Queue size: " << queue.size() << std::endl;
-        pvector<bool> visited(ds->num_nodes, false); 
+        // frontier depths differ here, so the pull rounds start from their minimum;
+        // like GAP, at least one push round follows a switch back
+        if(!pulled && (BFSFrontierEdges(ds, queue) > ds->num_edges / kBFSAlpha)){
+            Depth min_depth = std::numeric_limits<Depth>::max();
+            #pragma omp parallel for reduction(min : min_depth)
+            for(auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++)
+                min_depth = std::min(min_depth, depth[*q_iter]);
+            BFSBottomUpRounds(ds, depth, queue, ws.front, ws.next_front, min_depth);
+            pulled = true;
+            continue;
+        }
+        pulled = false;
+
+        epoch_set& visited = ws.visited;
+        visited.reset(ds->num_nodes);
 
         #pragma omp parallel
         {
@@ -108,24 +223,22 @@ void dynBFSAlg(T* ds, NodeID source){
             #pragma omp for schedule(dynamic, 64)
             for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
                 NodeID n = *q_iter;                        
+                prefetch_frontier(ds, q_iter, queue.end(), false, &depth[0]);
                 for(auto v: out_neigh(n, ds)){
-                    float curr_depth = ds->property[v];
-                    float new_depth = ds->property[n] + 1;
+                    Depth curr_depth = depth[v];
+                    Depth new_depth = depth[n] + 1;
                     /*if((new_depth < curr_depth) || (curr_depth == -1)){
-                        if(compare_and_swap(ds->property[v], curr_depth, new_depth)){                            
+                        if(compare_and_swap(depth[v], curr_depth, new_depth)){                            
                             lqueue.push_back(v);
                         }
                     }*/
 
                     if((new_depth < curr_depth) || (curr_depth == -1)){
-                        bool curr_val = visited[v];
-                        if(!curr_val){
-                            if(compare_and_swap(visited[v], curr_val, true))
-                                    lqueue.push_back(v);
-                        }
+                        if(visited.insert(v))
+                            lqueue.push_back(v);
 
-                        while(!compare_and_swap(ds->property[v], curr_depth, new_depth)){
-                            curr_depth = ds->property[v];
+                        while(!compare_and_swap(depth[v], curr_depth, new_depth)){
+                            curr_depth = depth[v];
                             if(curr_depth <= new_depth){
                                 break;
                             }
@@ -138,57 +251,73 @@ void dynBFSAlg(T* ds, NodeID source){
         queue.slide_window();               
     }    
 
-    // clear affected array to get ready for the next update round
-    #pragma omp parallel for schedule(dynamic, 64)
-    for(NodeID i = 0; i < ds->num_nodes; i++){
-        ds->affected[i] = false;
-    }
-
     t.Stop();    
     ofstream out("Alg.csv", std::ios_base::app);   
     out << t.Seconds() << std::endl;    
     out.close();
 }  
 
+// push round from scratch: claims unreached out-neighbors and returns their outgoing edges
+template<typename T>
+int64_t BFSTopDownStep(T* ds, vertex_property<Depth>& depth, SlidingQueue<NodeID>& queue){
+    degree_view deg = ds->degrees();
+    int64_t scout_count = 0;
+    #pragma omp parallel reduction(+ : scout_count)
+    {             
+        QueueBuffer<NodeID> lqueue(queue);
+        #pragma omp for 
+        for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
+            NodeID u = *q_iter;
+            for(auto v: out_neigh(u, ds)){
+                Depth curr_depth = depth[v];
+                Depth new_depth = depth[u] + 1;
+                if(curr_depth < 0){
+                    if(compare_and_swap(depth[v], curr_depth, new_depth)){
+                        lqueue.push_back(v);
+                        scout_count += deg.out_degree(v);
+                    }
+                }
+            }
+        }
+        lqueue.flush();
+    }
+    return scout_count;
+}
+
 template<typename T> 
-void BFSStartFromScratch(T* ds, NodeID source){  
+void BFSStartFromScratch(T* ds, vertex_property<Depth>& depth, NodeID source){  
     //std::cout << "Source " << source << std::endl;
     std::cout << "Running BFS from scratch" << std::endl;
 
     Timer t;
     t.Start(); 
+    depth.resize(ds->num_nodes);
 
     #pragma omp parallel for 
     for(NodeID n = 0; n < ds->num_nodes; n++)
-        ds->property[n] = -1;
+        depth[n] = -1;
 
-    ds->property[source] = 0;    
+    depth[source] = 0;    
 
     SlidingQueue<NodeID> queue(ds->num_nodes);   
     queue.push_back(source);
     queue.slide_window();  
 
+    Bitmap front, next;
+    Depth level = 0;    // depth of the current frontier
+    int64_t edges_to_check = ds->num_edges;
+    int64_t scout_count = ds->degrees().out_degree(source);
     while(!queue.empty()){       
         //std::cout << "Queue not empty, Queue size: " << queue.size() << std::endl;         
-        #pragma omp parallel
-        {             
-            QueueBuffer<NodeID> lqueue(queue);
-            #pragma omp for 
-            for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
-                NodeID u = *q_iter;
-                for(auto v: out_neigh(u, ds)){
-                    float curr_depth = ds->property[v];
-                    float new_depth = ds->property[u] + 1;
-                    if(curr_depth < 0){
-                        if(compare_and_swap(ds->property[v], curr_depth, new_depth)){
-                            lqueue.push_back(v);
-                        }
-                    }
-                }
-            }
-            lqueue.flush();
+        if(scout_count > edges_to_check / kBFSAlpha){
+            level = BFSBottomUpRounds(ds, depth, queue, front, next, level);
+            scout_count = 1;
+        } else {
+            edges_to_check -= scout_count;
+            scout_count = BFSTopDownStep(ds, depth, queue);
+            queue.slide_window();
+            level++;
         }
-        queue.slide_window();        
     }
 
     t.Stop();    
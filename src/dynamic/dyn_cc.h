@@ -6,90 +6,120 @@
 #include "traversal.h"
 #include "../common/timer.h"
 #include "sliding_queue_dynamic.h"
+#include "workspace.h"
+#include "prefetch.h"
+#include "property.h"
 #include "../common/pvector.h"
 
 /* Algorithm: Incremental CC and CC starting from scratch */
 
-typedef float Component;
+typedef Label Component;    // kNoLabel until the vertex is seen
 
+// pulls and pushes the hubs deferred by a round range by range; in
+// iteration 0 (first) a vertex still holding its own ID always triggers
 template<typename T>
-void CCIter0(T* ds, SlidingQueue<NodeID>& queue){
-    pvector<bool> visited(ds->num_nodes, false);
+void CCHubRound(T* ds, vertex_property<Component>& comp, hub_split& hubs, SlidingQueue<NodeID>& queue,
+                epoch_set& visited, bool first){
+    hub_round(ds, hubs, ds->directed, kNoLabel,
+        [&](const neighbor_block& b){
+            Component low = kNoLabel;
+            for(int64_t i = 0; i < b.count; i++)
+                low = std::min(low, comp[b.id(i)]);
+            return low;
+        },
+        [](Component a, Component b){ return std::min(a, b); },
+        [&](NodeID n, Component low){
+            Component old_comp = comp[n];
+            comp[n] = std::min(old_comp, low);
+            return (comp[n] < old_comp) || (first && old_comp == n);
+        },
+        queue, visited);
+}
+
+template<typename T>
+void CCIter0(T* ds, vertex_property<Component>& comp, SlidingQueue<NodeID>& queue, algo_workspace& ws){
+    epoch_set& visited = ws.visited;
+    visited.reset(ds->num_nodes);
+    degree_view deg = ds->degrees();
+    hub_split& hubs = ws.hubs;
+    hubs.reset();
     
     #pragma omp parallel     
     {
         QueueBuffer<NodeID> lqueue(queue);
         #pragma omp for schedule(dynamic, 64)
-        for(NodeID n=0; n < ds->num_nodes; n++){
-            if(ds->affected[n]){
-                Component old_comp = ds->property[n];
-                Component new_comp = old_comp;
+        for(auto a_iter = ds->affected.begin(); a_iter < ds->affected.end(); a_iter++){
+            NodeID n = *a_iter;
+            if(hub_split::is_hub(deg, n)){
+                hubs.defer(n);
+                continue;
+            }
+            Component old_comp = comp[n];
+            Component new_comp = old_comp;
 
-                // calculate new component
-                for(auto v: in_neigh(n, ds)){
-                    if(ds->property[v] < new_comp) new_comp = ds->property[v];
-                }
+            // calculate new component
+            for(auto v: in_neigh(n, ds)){
+                if(comp[v] < new_comp) new_comp = comp[v];
+            }
 
-                if(ds->directed){                    
-                    for(auto v: out_neigh(n, ds)){
-                        if(ds->property[v] < new_comp) new_comp = ds->property[v];
-                    }
+            if(ds->directed){                    
+                for(auto v: out_neigh(n, ds)){
+                    if(comp[v] < new_comp) new_comp = comp[v];
                 }
+            }
 
-                assert(new_comp<= old_comp);
+            assert(new_comp<= old_comp);
 
-                ds->property[n] = new_comp;                                
-                bool trigger = ((ds->property[n] < old_comp) || (old_comp == n)); 
-
-                if(trigger){                   
-                    //put the out-neighbors into active list 
-                    for(auto v: in_neigh(n, ds)){                        
-                        bool curr_val = visited[v];
-                        if(!curr_val){
-                            if(compare_and_swap(visited[v], curr_val, true)) 
-                                 lqueue.push_back(v);
-                        }                       
-                    }
+            comp[n] = new_comp;                                
+            bool trigger = ((comp[n] < old_comp) || (old_comp == n)); 
 
-                    if(ds->directed){
-                        for(auto v: out_neigh(n, ds)){
-                            bool curr_val = visited[v];
-                            if(!curr_val){
-                                if(compare_and_swap(visited[v], curr_val, true)) 
-                                     lqueue.push_back(v);
-                            }             
-                        }
-                    }                                                
-                }        
-            }
+            if(trigger){                   
+                //put the out-neighbors into active list 
+                for(auto v: in_neigh(n, ds)){                        
+                    if(visited.insert(v))
+                        lqueue.push_back(v);
+                }
+
+                if(ds->directed){
+                    for(auto v: out_neigh(n, ds)){
+                        if(visited.insert(v))
+                            lqueue.push_back(v);
+                    }
+                }                                                
+            }        
         }
         lqueue.flush();
     }   
+    CCHubRound(ds, comp, hubs, queue, visited, true);
 }
 
 template<typename T>
-void dynCCAlg(T* ds){
+void dynCCAlg(T* ds, vertex_property<Component>& comp, algo_workspace& ws){
     std::cout << "Running dynamic CC" << std::endl;
 
     Timer t;
     t.Start();
+    comp.resize(ds->num_nodes);
 
-    SlidingQueue<NodeID> queue(ds->num_nodes);      
+    SlidingQueue<NodeID>& queue = ws.frontier(ds->num_nodes);      
     
     // Assign component of newly added vertices
     #pragma omp parallel for schedule(dynamic, 64)
     for(NodeID n = 0; n < ds->num_nodes; n++){
-        if(ds->property[n] == -1){
-            ds->property[n] = n;
+        if(comp[n] == kNoLabel){
+            comp[n] = n;
         }
     }    
    
-    CCIter0(ds, queue);
+    CCIter0(ds, comp, queue, ws);
     queue.slide_window();   
     
     while(!queue.empty()){             
         //std::cout << "Queue not empty, Queue size: " << queue.size() << std::endl;
-        pvector<bool> visited(ds->num_nodes, false);         
+        epoch_set& visited = ws.visited;
+        visited.reset(ds->num_nodes);
+        degree_view deg = ds->degrees();
+        ws.hubs.reset();
        
         #pragma omp parallel
         {
@@ -97,72 +127,135 @@ void dynCCAlg(T* ds){
             #pragma omp for schedule(dynamic, 64)
             for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
                 NodeID n = *q_iter;
-                Component old_comp = ds->property[n];
+                prefetch_frontier(ds, q_iter, queue.end(), true, &comp[0]);
+                if(hub_split::is_hub(deg, n)){
+                    ws.hubs.defer(n);
+                    continue;
+                }
+                Component old_comp = comp[n];
                 Component new_comp = old_comp;
 
                 // calculate new component
                 for(auto v: in_neigh(n, ds)){
-                    if(ds->property[v] < new_comp) new_comp = ds->property[v];
+                    if(comp[v] < new_comp) new_comp = comp[v];
                 }
 
                 if(ds->directed){
                     for(auto v: out_neigh(n, ds)){
-                        if(ds->property[v] < new_comp) new_comp = ds->property[v];
+                        if(comp[v] < new_comp) new_comp = comp[v];
                     }
                 }
 
                 assert(new_comp<= old_comp);
-                ds->property[n] = new_comp;                
-                bool trigger = (ds->property[n] < old_comp); 
+                comp[n] = new_comp;                
+                bool trigger = (comp[n] < old_comp); 
 
                 if(trigger){
                     for(auto v: in_neigh(n, ds)){  
-                        bool curr_val = visited[v];
-                        if(!curr_val){
-                            if(compare_and_swap(visited[v], curr_val, true)) 
-                                   lqueue.push_back(v);
-                        }                                                                    
+                        if(visited.insert(v))
+                            lqueue.push_back(v);
                     }
 
                     if(ds->directed){
                         for(auto v: out_neigh(n, ds)){  
-                            bool curr_val = visited[v];
-                            if(!curr_val){
-                                if(compare_and_swap(visited[v], curr_val, true)) 
-                                      lqueue.push_back(v);
-                            }                                                                   
+                            if(visited.insert(v))
+                                lqueue.push_back(v);
                         }
                     }
                 }
             }
             lqueue.flush();
         }
+        CCHubRound(ds, comp, ws.hubs, queue, visited, false);
         queue.slide_window();            
     }    
 
-    // clear affected array to get ready for the next update round
-    #pragma omp parallel for schedule(dynamic, 64)
-    for(NodeID i = 0; i < ds->num_nodes; i++){
-        ds->affected[i] = false;
-    }        
-
     t.Stop();
     ofstream out("Alg.csv", std::ios_base::app);   
     out << t.Seconds() << std::endl;    
     out.close();
 }
 
+// root of x, halving the path on the way; every parent is lower than its
+// child, so a root is the smallest ID in its component
+inline Component CCFind(vertex_property<Component>& comp, Component x){
+    while(true){
+        Component p = comp[x];
+        if(p == x)
+            return x;
+        Component gp = comp[p];
+        if(p != gp)
+            compare_and_swap(comp[x], p, gp);
+        x = gp;
+    }
+}
+
+// hooks the higher of the two roots under the lower; returns true if this
+// call merged two components
+inline bool CCUnion(vertex_property<Component>& comp, Component u, Component v){
+    while(true){
+        Component ru = CCFind(comp, u);
+        Component rv = CCFind(comp, v);
+        if(ru == rv)
+            return false;
+        Component high = std::max(ru, rv);
+        Component low = std::min(ru, rv);
+        if(compare_and_swap(comp[high], high, low))
+            return true;
+        // high was hooked by another thread meanwhile, retry from the new roots
+    }
+}
+
+/* Incremental CC by lock-free union-find, for insert-only streams.
+   Only the batch's edges are visited: each one unions its endpoints'
+   trees with CAS. A flattening pass then points every vertex straight at
+   its root, so the labels are the smallest vertex IDs of the components,
+   the same as dynCCAlg's. The pass is skipped for batches that merged
+   nothing. Edge direction is ignored, as in dynCCAlg. */
+inline void dynCCUnionFindAlg(dataStruc* ds, const EdgeList& el, vertex_property<Component>& comp){
+    std::cout << "Running dynamic CC (union-find)" << std::endl;
+
+    Timer t;
+    t.Start();
+    int64_t old_nodes = comp.size();
+    comp.resize(ds->num_nodes);
+    #pragma omp parallel for
+    for(NodeID n = old_nodes; n < ds->num_nodes; n++)
+        comp[n] = n;
+
+    int64_t merges = 0;
+    #pragma omp parallel for reduction(+ : merges) schedule(dynamic, 1024)
+    for(size_t i = 0; i < el.size(); i++){
+        if(CCUnion(comp, el[i].source, el[i].destination))
+            merges++;
+    }
+
+    if(merges > 0){
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for(NodeID n = 0; n < ds->num_nodes; n++){
+            while(comp[n] != comp[comp[n]])
+                comp[n] = comp[comp[n]];
+        }
+    }
+
+    t.Stop();
+    ofstream out("Alg.csv", std::ios_base::app);
+    out << t.Seconds() << std::endl;
+    out.close();
+}
+
 template<typename T>
-void CCStartFromScratch(T* ds){ 
+void CCStartFromScratch(T* ds, vertex_property<Component>& comp){ 
     //std::cout << "Number of nodes: "<< ds->num_nodes << std::endl;
     std::cout << "Running CC from scratch" << std::endl;
 
     Timer t;
     t.Start();
+    comp.resize(ds->num_nodes);
 
     #pragma omp parallel for
     for (NodeID n=0; n < ds->num_nodes; n++)
-       ds->property[n] = n;   
+       comp[n] = n;   
 
     bool change = true;
     int num_iter = 0;  
@@ -174,23 +267,23 @@ void CCStartFromScratch(T* ds){
             #pragma omp parallel for
             for (NodeID u=0; u < ds->num_nodes; u++) {
                 for (NodeID v : out_neigh(u, ds)){
-                    NodeID comp_u = ds->property[u];
-                    NodeID comp_v = ds->property[v];
+                    NodeID comp_u = comp[u];
+                    NodeID comp_v = comp[v];
                     if (comp_u == comp_v) continue;
                     // Hooking condition so lower component ID wins independent of direction
                     NodeID high_comp = comp_u > comp_v ? comp_u : comp_v;
                     NodeID low_comp = comp_u + (comp_v - high_comp);
-                    if (high_comp == ds->property[high_comp]) {
+                    if (high_comp == comp[high_comp]) {
                         change = true;
-                        ds->property[high_comp] = low_comp;
+                        comp[high_comp] = low_comp;
                     }
                 }
             }
 
             #pragma omp parallel for
             for (NodeID n=0; n < ds->num_nodes; n++){
-                while (ds->property[n] != ds->property[ds->property[n]]){
-                    ds->property[n] = ds->property[ds->property[n]];
+                while (comp[n] != comp[comp[n]]){
+                    comp[n] = comp[comp[n]];
                 }
             }
         }
@@ -201,23 +294,23 @@ void CCStartFromScratch(T* ds){
             num_iter++;
             #pragma omp parallel for
             for (NodeID u=0; u < ds->num_nodes; u++) {
-                NodeID comp_u = ds->property[u];
+                NodeID comp_u = comp[u];
                 for (NodeID v : out_neigh(u, ds)) {
-                    NodeID comp_v = ds->property[v];
+                    NodeID comp_v = comp[v];
                     // To prevent cycles, we only perform a hook in a consistent direction
                     // (comp_u < comp_v). Since the graph is undirected, the condition
                     // will be true from one side.
-                    if ((comp_u < comp_v) && (comp_v == ds->property[comp_v])) {
+                    if ((comp_u < comp_v) && (comp_v == comp[comp_v])) {
                         change = true;
-                        ds->property[comp_v] = comp_u;
+                        comp[comp_v] = comp_u;
                     }
                 }
             }
 
             #pragma omp parallel for
             for (NodeID n=0; n < ds->num_nodes; n++) {
-                while (ds->property[n] != ds->property[ds->property[n]]) {
-                    ds->property[n] = ds->property[ds->property[n]];
+                while (comp[n] != comp[comp[n]]) {
+                    comp[n] = comp[comp[n]];
                 }
             }
         }
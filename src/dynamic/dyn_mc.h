@@ -6,75 +6,108 @@
 #include "traversal.h"
 #include "../common/timer.h"
 #include "sliding_queue_dynamic.h"
+#include "workspace.h"
+#include "prefetch.h"
+#include "property.h"
 #include "../common/pvector.h"
 
 /* Algorithm: Incremental Max computation and Max Computation starting from scratch */
 
+// pulls and pushes the hubs deferred by a round range by range; in
+// iteration 0 (first) a vertex still holding its own ID always triggers
 template<typename T>
-void MCIter0(T* ds, SlidingQueue<NodeID>& queue){
-    pvector<bool> visited(ds->num_nodes, false);
+void MCHubRound(T* ds, vertex_property<Label>& label, hub_split& hubs, SlidingQueue<NodeID>& queue,
+                epoch_set& visited, bool first){
+    hub_round(ds, hubs, false, Label(0),
+        [&](const neighbor_block& b){
+            Label high = 0;
+            for(int64_t i = 0; i < b.count; i++)
+                high = std::max(high, label[b.id(i)]);
+            return high;
+        },
+        [](Label a, Label b){ return std::max(a, b); },
+        [&](NodeID n, Label high){
+            Label old_val = label[n];
+            label[n] = std::max(old_val, high);
+            return (label[n] > old_val) || (first && old_val == n);
+        },
+        queue, visited);
+}
+
+template<typename T>
+void MCIter0(T* ds, vertex_property<Label>& label, SlidingQueue<NodeID>& queue, algo_workspace& ws){
+    epoch_set& visited = ws.visited;
+    visited.reset(ds->num_nodes);
+    degree_view deg = ds->degrees();
+    hub_split& hubs = ws.hubs;
+    hubs.reset();
     
     #pragma omp parallel     
     {
         QueueBuffer<NodeID> lqueue(queue);
         #pragma omp for schedule(dynamic, 64)
-        for(NodeID n=0; n < ds->num_nodes; n++){
-            if(ds->affected[n]){
-                float old_val = ds->property[n];
-                float new_val = old_val;
-
-                // calculate new value
-                for(auto v: in_neigh(n, ds)){
-                    new_val = std::max(new_val, ds->property[v]);
-                }
-                
-                assert(new_val >= old_val);
-
-                ds->property[n] = new_val;                                
-                bool trigger = (
-                    (ds->property[n] > old_val)
-                    || (old_val == n)
-                ); 
+        for(auto a_iter = ds->affected.begin(); a_iter < ds->affected.end(); a_iter++){
+            NodeID n = *a_iter;
+            if(hub_split::is_hub(deg, n)){
+                hubs.defer(n);
+                continue;
+            }
+            Label old_val = label[n];
+            Label new_val = old_val;
 
-                if(trigger){                   
-                    //put the out-neighbors into active list 
-                    for(auto v: out_neigh(n, ds)){
-                        bool curr_val = visited[v];
-                        if(!curr_val){
-                            if(compare_and_swap(visited[v], curr_val, true)) 
-                                 lqueue.push_back(v);
-                        }             
-                    }                                                                    
-                }        
+            // calculate new value
+            for(auto v: in_neigh(n, ds)){
+                new_val = std::max(new_val, label[v]);
             }
+            
+            assert(new_val >= old_val);
+
+            label[n] = new_val;                                
+            bool trigger = (
+                (label[n] > old_val)
+                || (old_val == n)
+            ); 
+
+            if(trigger){                   
+                //put the out-neighbors into active list 
+                for(auto v: out_neigh(n, ds)){
+                    if(visited.insert(v))
+                        lqueue.push_back(v);
+                }                                                                    
+            }        
         }
         lqueue.flush();
     }
+    MCHubRound(ds, label, hubs, queue, visited, true);
 }
 
 template<typename T>
-void dynMCAlg(T* ds){
+void dynMCAlg(T* ds, vertex_property<Label>& label, algo_workspace& ws){
     //std::cout << "Number of nodes: "<< ds->num_nodes << std::endl;   
     std::cout << "Running dynamic MC" << std::endl;
     Timer t;
     t.Start();   
+    label.resize(ds->num_nodes);
 
-    SlidingQueue<NodeID> queue(ds->num_nodes);        
+    SlidingQueue<NodeID>& queue = ws.frontier(ds->num_nodes);        
     
     // Assign value of newly added vertices
     #pragma omp parallel for schedule(dynamic, 64)
     for(NodeID n = 0; n < ds->num_nodes; n++){
-        if(ds->property[n] == -1){
-            ds->property[n] = n;
+        if(label[n] == kNoLabel){
+            label[n] = n;
         }
     }        
 
-    MCIter0(ds, queue);
+    MCIter0(ds, label, queue, ws);
     queue.slide_window();   
     
     while(!queue.empty()){             
         //std::cout << "Queue not empty, Queue size: " << queue.size() << std::endl;
-        pvector<bool> visited(ds->num_nodes, false);         
+        epoch_set& visited = ws.visited;
+        visited.reset(ds->num_nodes);
+        degree_view deg = ds->degrees();
+        ws.hubs.reset();
         
         #pragma omp parallel
         {
@@ -82,40 +115,37 @@ void dynMCAlg(T* ds){
             #pragma omp for schedule(dynamic, 64)
             for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
                 NodeID n = *q_iter;
-                float old_val = ds->property[n];
-                float new_val = old_val;
+                prefetch_frontier(ds, q_iter, queue.end(), true, &label[0]);
+                if(hub_split::is_hub(deg, n)){
+                    ws.hubs.defer(n);
+                    continue;
+                }
+                Label old_val = label[n];
+                Label new_val = old_val;
 
                 // calculate new value
                 for(auto v: in_neigh(n, ds)){
-                    new_val = std::max(new_val, ds->property[v]);
+                    new_val = std::max(new_val, label[v]);
                 }
 
                 assert(new_val >= old_val);
 
-                ds->property[n] = new_val;                
-                bool trigger = (ds->property[n] > old_val); 
+                label[n] = new_val;                
+                bool trigger = (label[n] > old_val); 
 
                 if(trigger){
                     for(auto v: out_neigh(n, ds)){  
-                        bool curr_val = visited[v];
-                        if(!curr_val){
-                            if(compare_and_swap(visited[v], curr_val, true)) 
-                                 lqueue.push_back(v);
-                        }                                                                   
+                        if(visited.insert(v))
+                            lqueue.push_back(v);
                     }                    
                 }
             }
             lqueue.flush();
         }
+        MCHubRound(ds, label, ws.hubs, queue, visited, false);
         queue.slide_window();        
     }   
 
-    // clear affected array to get ready for the next update round
-    #pragma omp parallel for schedule(dynamic, 64)
-    for(NodeID i = 0; i < ds->num_nodes; i++){
-        ds->affected[i] = false;
-    }     
-
     t.Stop();    
     ofstream out("Alg.csv", std::ios_base::app);   
     out << t.Seconds() << std::endl;    
@@ -123,15 +153,16 @@ void dynMCAlg(T* ds){
 }
 
 template<typename T>
-void MCStartFromScratch(T* ds){ 
+void MCStartFromScratch(T* ds, vertex_property<Label>& label){ 
     std::cout << "Running MC from scratch" << std::endl;
 
     Timer t;
     t.Start();
+    label.resize(ds->num_nodes);
 
     #pragma omp parallel for
     for (NodeID n=0; n < ds->num_nodes; n++)
-       ds->property[n] = n;
+       label[n] = n;
     
     SlidingQueue<NodeID> queue(ds->num_nodes);   
     pvector<bool> visited(ds->num_nodes, false); 
@@ -142,17 +173,17 @@ void MCStartFromScratch(T* ds){
         QueueBuffer<NodeID> lqueue(queue);
         #pragma omp for 
         for(NodeID n = 0; n < ds->num_nodes; n++){
-            float old_val = ds->property[n];
-            float new_val = old_val;
+            Label old_val = label[n];
+            Label new_val = old_val;
 
             for(auto v: in_neigh(n, ds)){
-                new_val = std::max(new_val, ds->property[v]);
+                new_val = std::max(new_val, label[v]);
             }
             assert(new_val >= old_val);
 
-            ds->property[n] = new_val;
+            label[n] = new_val;
 
-            if(ds->property[n] != old_val){
+            if(label[n] != old_val){
                 for(auto w: out_neigh(n, ds)){
                     bool curr_val = visited[w];
                     if(!curr_val){
@@ -176,17 +207,17 @@ void MCStartFromScratch(T* ds){
             #pragma omp for
             for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
                 NodeID n = *q_iter;
-                float old_val = ds->property[n];
-                float new_val = old_val;
+                Label old_val = label[n];
+                Label new_val = old_val;
 
                 for(auto v: in_neigh(n, ds)){
-                    new_val = std::max(new_val, ds->property[v]);
+                    new_val = std::max(new_val, label[v]);
                 }
                 assert(new_val >= old_val);
 
-                ds->property[n] = new_val;                               
+                label[n] = new_val;                               
 
-                if(ds->property[n] != old_val){
+                if(label[n] != old_val){
                     for(auto w: out_neigh(n, ds)){  
                         bool curr_val = visited[w];
                         if(!curr_val){
@@ -221,8 +252,8 @@ void MCStartFromScratch(const string& datatype, T* partition, bool directed){
         num_iter++;
         #pragma omp parallel for
         for(NodeID n = 0; n < partition->num_nodes; n++){
-            float old_val = partition->property[n];
-            float new_val = old_val;
+            Label old_val = partition->property[n];
+            Label new_val = old_val;
 
             for(auto v: in_neigh(n, datatype, partition, partition->directed)){
                 new_val = std::max(new_val, partition->property[v]);
@@ -0,0 +1,218 @@
+#ifndef DYN_MSBFS_H_
+#define DYN_MSBFS_H_
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+#include "traversal.h"
+#include "../common/timer.h"
+#include "sliding_queue_dynamic.h"
+#include "workspace.h"
+#include "property.h"
+#include "dyn_bfs.h"
+
+/* Algorithm: Incremental multi-source BFS (MS-BFS) and MS-BFS starting from scratch
+
+   Tracks reachability and hop distance from up to 64 landmarks at once.
+   Every vertex keeps a bitmask of the landmarks that reach it, and a
+   frontier vertex carries the mask of landmarks that advanced through it in
+   the last round. One pass over out_neigh() therefore moves all of those
+   landmarks together instead of running one BFS per landmark. */
+
+typedef uint64_t LandmarkMask;     // bit i: reached from landmarks[i]
+const int kMaxLandmarks = 64;
+// one byte per (vertex, landmark): hop counts saturate at kMaxHops, far
+// beyond the BFS depth of real graphs
+typedef uint8_t Hops;
+const Hops kNoHops = std::numeric_limits<Hops>::max();
+const Hops kMaxHops = kNoHops - 1;
+typedef std::array<Hops, kMaxLandmarks> LandmarkHops;   // kNoHops until reached
+
+inline LandmarkHops unreachedHops(){
+    LandmarkHops h;
+    h.fill(kNoHops);
+    return h;
+}
+
+// queues v once per round and adds bits to its pending landmarks
+inline void markLandmarks(std::vector<LandmarkMask>& next, NodeID v, LandmarkMask bits, QueueBuffer<NodeID>& lqueue){
+    if(__sync_fetch_and_or(&next[v], bits) == 0)
+        lqueue.push_back(v);
+}
+
+// lowers to[i] to from[i] + 1 (at most kMaxHops) for every landmark i in
+// bits; returns the landmarks whose hops changed
+inline LandmarkMask relaxLandmarks(LandmarkHops& from, LandmarkHops& to, LandmarkMask bits){
+    LandmarkMask lowered = 0;
+    for(; bits; bits &= bits - 1){
+        int i = __builtin_ctzll(bits);
+        Hops h = from[i];
+        if((h != kNoHops) && atomic_min(to[i], std::min<Hops>(h + 1, kMaxHops)))
+            lowered |= LandmarkMask(1) << i;
+    }
+    return lowered;
+}
+
+template<typename T>
+void MSBFSIter0(T* ds, vertex_property<LandmarkMask>& reach, vertex_property<LandmarkHops>& hops,
+                const std::vector<NodeID>& landmarks, SlidingQueue<NodeID>& queue, std::vector<LandmarkMask>& next){
+    #pragma omp parallel
+    {
+        QueueBuffer<NodeID> lqueue(queue);
+
+        // landmarks that are new to the graph start at hop 0
+        #pragma omp for
+        for(size_t i = 0; i < landmarks.size(); i++){
+            NodeID s = landmarks[i];
+            LandmarkMask bit = LandmarkMask(1) << i;
+            if(hops[s][i] != 0){
+                hops[s][i] = 0;
+                __sync_fetch_and_or(&reach[s], bit);
+                markLandmarks(next, s, bit, lqueue);
+            }
+        }
+
+        // pull hops from incoming neighbors of affected vertices
+        #pragma omp for schedule(dynamic, 64)
+        for(auto a_iter = ds->affected.begin(); a_iter < ds->affected.end(); a_iter++){
+            NodeID n = *a_iter;
+            LandmarkMask lowered = 0;
+            for(auto v: in_neigh(n, ds))
+                lowered |= relaxLandmarks(hops[v], hops[n], reach[v]);
+            if(lowered){
+                __sync_fetch_and_or(&reach[n], lowered);
+                markLandmarks(next, n, lowered, lqueue);
+            }
+        }
+        lqueue.flush();
+    }
+}
+
+template<typename T>
+void dynMSBFSAlg(T* ds, vertex_property<LandmarkMask>& reach, vertex_property<LandmarkHops>& hops,
+                 const std::vector<NodeID>& landmarks, algo_workspace& ws){
+    std::cout << "Running dynamic multi-source BFS " << std::endl;
+
+    Timer t;
+    t.Start();
+    reach.resize(ds->num_nodes);
+    hops.resize(ds->num_nodes);
+
+    // visit: landmarks a frontier vertex pushes this round
+    // next: landmarks lowered at a vertex since it was last queued, all zero between rounds
+    std::vector<LandmarkMask>& visit = ws.masks;
+    std::vector<LandmarkMask>& next = ws.next_masks;
+    visit.resize(ds->num_nodes);
+    next.resize(ds->num_nodes, 0);
+
+    SlidingQueue<NodeID>& queue = ws.frontier(ds->num_nodes);
+    MSBFSIter0(ds, reach, hops, landmarks, queue, next);
+    queue.slide_window();
+
+    while(!queue.empty()){
+        #pragma omp parallel for
+        for(auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
+            NodeID u = *q_iter;
+            visit[u] = next[u];
+            next[u] = 0;
+        }
+
+        #pragma omp parallel
+        {
+            QueueBuffer<NodeID> lqueue(queue);
+            #pragma omp for schedule(dynamic, 64)
+            for(auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
+                NodeID u = *q_iter;
+                LandmarkMask bits = visit[u];
+                for(auto v: out_neigh(u, ds)){
+                    LandmarkMask lowered = relaxLandmarks(hops[u], hops[v], bits);
+                    if(lowered){
+                        __sync_fetch_and_or(&reach[v], lowered);
+                        markLandmarks(next, v, lowered, lqueue);
+                    }
+                }
+            }
+            lqueue.flush();
+        }
+        queue.slide_window();
+    }
+
+    t.Stop();
+    ofstream out("Alg.csv", std::ios_base::app);
+    out << t.Seconds() << std::endl;
+    out.close();
+}
+
+template<typename T>
+void MSBFSStartFromScratch(T* ds, vertex_property<LandmarkMask>& reach, vertex_property<LandmarkHops>& hops,
+                           const std::vector<NodeID>& landmarks){
+    std::cout << "Running multi-source BFS from scratch" << std::endl;
+
+    Timer t;
+    t.Start();
+    reach.resize(ds->num_nodes);
+    hops.resize(ds->num_nodes);
+
+    #pragma omp parallel for
+    for(NodeID n = 0; n < ds->num_nodes; n++){
+        reach[n] = 0;
+        hops[n].fill(kNoHops);
+    }
+
+    // level-synchronous: each landmark reaches a vertex in exactly one round,
+    // so a round only ORs masks and hops are written once per (vertex, landmark)
+    std::vector<LandmarkMask> visit(ds->num_nodes);
+    std::vector<LandmarkMask> next(ds->num_nodes, 0);
+    SlidingQueue<NodeID> queue(ds->num_nodes);
+    for(size_t i = 0; i < landmarks.size(); i++){
+        NodeID s = landmarks[i];
+        if(reach[s] == 0)
+            queue.push_back(s);
+        reach[s] |= LandmarkMask(1) << i;
+        hops[s][i] = 0;
+    }
+    queue.slide_window();
+    for(auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++)
+        visit[*q_iter] = reach[*q_iter];
+
+    Depth level = 0;
+    while(!queue.empty()){
+        level++;
+        #pragma omp parallel
+        {
+            QueueBuffer<NodeID> lqueue(queue);
+            #pragma omp for schedule(dynamic, 64)
+            for(auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
+                NodeID u = *q_iter;
+                LandmarkMask bits = visit[u];
+                for(auto v: out_neigh(u, ds)){
+                    LandmarkMask fresh = bits & ~reach[v];
+                    if(fresh & ~next[v])
+                        markLandmarks(next, v, fresh, lqueue);
+                }
+            }
+            lqueue.flush();
+        }
+        queue.slide_window();
+
+        // vertices reached this round take their new landmarks
+        #pragma omp parallel for
+        for(auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
+            NodeID v = *q_iter;
+            LandmarkMask fresh = next[v];
+            next[v] = 0;
+            visit[v] = fresh;
+            reach[v] |= fresh;
+            for(; fresh; fresh &= fresh - 1)
+                hops[v][__builtin_ctzll(fresh)] = std::min<Depth>(level, kMaxHops);
+        }
+    }
+
+    t.Stop();
+    ofstream out("Alg.csv", std::ios_base::app);
+    out << t.Seconds() << std::endl;
+    out.close();
+}
+#endif  // DYN_MSBFS_H_
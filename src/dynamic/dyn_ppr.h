@@ -0,0 +1,366 @@
+#ifndef DYN_PPR_H_
+#define DYN_PPR_H_
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "traversal.h"
+#include "neighbor_block.h"
+#include "../common/timer.h"
+#include "workspace.h"
+#include "dyn_prpush.h"
+
+/* Algorithm: Incremental Monte Carlo PageRank and personalized PageRank
+
+   Every vertex starts kWalksPerVertex random walks. A walk stops with
+   probability 1 - kDamp before each step and at vertices without
+   out-edges, otherwise it moves to a uniformly chosen out-neighbor. With V
+   the number of visits to v over all walks, V * (1 - kDamp) /
+   (kWalksPerVertex * num_nodes) estimates the PageRank of v (property()),
+   and the walks starting at s estimate the PageRank personalized to s
+   (PPRTopK()).
+
+   When a batch gives u new out-edges, going from k to k' of them, the walks
+   are brought up to date as in Bahmani et al. Every walk that visited u
+   and moved on is rerouted there with probability (k' - k) / k', to one of
+   the new edges. A walk that stopped at u because u had no out-edges now
+   moves on. The rerouted part is then sampled again. Walks that never
+   reach u are left as they are.
+
+   Storage:
+   - Walks are stored per start vertex, as one flat array of steps.
+   - An index lists, per visited vertex, the walks that may pass through
+     it. It is updated lazily: stale entries are dropped when a list grows
+     to twice its vertex's visit count.
+   - Index updates are bucketed by vertex partition, so each partition is
+     filled by one thread without locks. */
+
+typedef uint64_t WalkID;                // start * kWalksPerVertex + i
+const int kWalksPerVertex = 8;
+const NodeID kWalkStop = -1;            // walk ended by the reset coin
+const NodeID kWalkDangling = -2;        // walk reached a vertex without out-edges
+const int kWalkPartitions = 256;        // index buckets, by vertex ID
+
+struct walk_store {
+    // per start vertex: the steps after the start of each of its walks,
+    // every walk closed by kWalkStop or kWalkDangling
+    std::vector<std::vector<NodeID>> walks;
+    std::vector<std::vector<WalkID>> index;    // per vertex: walks that may visit it
+    std::vector<int64_t> visits;               // per vertex: visits by all walks, starts included
+    std::vector<int64_t> degree;               // out-degree the walks were sampled with
+    std::vector<int64_t> change;               // per vertex: its arc group in this batch, or -1
+    uint64_t batch = 0;
+
+    bool empty() const { return walks.empty(); }
+
+    int64_t size() const { return walks.size(); }
+
+    void resize(int64_t n) {
+        if (size() >= n)
+            return;
+        walks.resize(n);
+        index.resize(n);
+        visits.resize(n, 0);
+        degree.resize(n, 0);
+        change.resize(n, -1);
+    }
+
+    // true if walk w still passes through v
+    bool visits_vertex(WalkID w, NodeID v) const {
+        NodeID s = w / kWalksPerVertex;
+        if (s == v)
+            return true;
+        const std::vector<NodeID> &steps = walks[s];
+        int64_t skip = w % kWalksPerVertex;
+        for (NodeID x : steps) {
+            if (x < 0) {
+                if (skip-- == 0)
+                    return false;
+            } else if (skip == 0 && x == v) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// splitmix64, seeded per start vertex and batch so walks don't depend on
+// the thread schedule
+struct walk_rng {
+    uint64_t state;
+
+    explicit walk_rng(uint64_t seed): state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    bool keep_walking() { return (next() >> 11) * (1.0 / 9007199254740992.0) < kDamp; }
+
+    int64_t below(int64_t n) { return next() % n; }
+};
+
+// index entries a thread adds, bucketed by partition
+struct walk_visits {
+    std::vector<std::vector<std::pair<NodeID, WalkID>>> added;
+
+    walk_visits(): added(kWalkPartitions) {}
+
+    void add(walk_store& store, NodeID v, WalkID w) {
+        __sync_fetch_and_add(&store.visits[v], 1);
+        added[v % kWalkPartitions].emplace_back(v, w);
+    }
+
+    void remove(walk_store& store, NodeID v) {
+        __sync_fetch_and_add(&store.visits[v], -1);
+    }
+};
+
+template<typename T>
+NodeID nthOutNeighbor(T* ds, NodeID u, int64_t j)
+{
+    return nth_neighbor(ds, u, false, j);
+}
+
+// walks on from x, which is already stored and counted, and closes the walk
+template<typename T>
+void extendWalk(T* ds, const degree_view& deg, walk_store& store, NodeID x, WalkID w,
+                walk_rng& rng, std::vector<NodeID>& steps, walk_visits& up)
+{
+    while (rng.keep_walking()) {
+        int64_t d = deg.out_degree(x);
+        x = d > 0 ? nthOutNeighbor(ds, x, rng.below(d)) : -1;
+        if (x == -1) {
+            steps.push_back(kWalkDangling);
+            return;
+        }
+        steps.push_back(x);
+        up.add(store, x, w);
+    }
+    steps.push_back(kWalkStop);
+}
+
+// next step of a walk at u, which got new out-edges this batch; -1 keeps the
+// old step (or the stop, for a walk that ended there)
+template<typename T>
+NodeID rerouteStep(T* ds, const degree_view& deg, const walk_store& store, NodeID u, bool moved_on,
+                   const std::vector<std::pair<NodeID, NodeID>>& arcs,
+                   const std::vector<size_t>& groups, walk_rng& rng)
+{
+    int64_t old_degree = store.degree[u];
+    int64_t new_degree = deg.out_degree(u);
+    size_t g = store.change[u];
+    int64_t batch_arcs = groups[g + 1] - groups[g];
+    if (!moved_on)
+        return nthOutNeighbor(ds, u, rng.below(new_degree));
+    // if the batch repeated old edges the new ones are unknown; sampling the
+    // step again from all of them is just as valid
+    if (batch_arcs != new_degree - old_degree)
+        return nthOutNeighbor(ds, u, rng.below(new_degree));
+    if (rng.below(new_degree) >= new_degree - old_degree)
+        return -1;
+    return arcs[groups[g] + rng.below(batch_arcs)].second;
+}
+
+// samples all walks of a new start s, or reroutes its walks listed in
+// [cand, cand_end) at the vertices that got new out-edges
+template<typename T>
+void updateWalks(T* ds, const degree_view& deg, walk_store& store, NodeID s,
+                 const WalkID* cand, const WalkID* cand_end,
+                 const std::vector<std::pair<NodeID, NodeID>>& arcs,
+                 const std::vector<size_t>& groups, walk_visits& up)
+{
+    walk_rng rng((static_cast<uint64_t>(s) << 20) ^ store.batch);
+    std::vector<NodeID> old_steps;
+    old_steps.swap(store.walks[s]);
+    std::vector<NodeID> &steps = store.walks[s];
+    bool fresh = old_steps.empty();
+    size_t pos = 0;
+    for (int i = 0; i < kWalksPerVertex; i++) {
+        WalkID w = static_cast<WalkID>(s) * kWalksPerVertex + i;
+        if (fresh) {
+            up.add(store, s, w);
+            extendWalk(ds, deg, store, s, w, rng, steps, up);
+            continue;
+        }
+        size_t begin = pos;
+        while (old_steps[pos] >= 0)
+            pos++;
+        size_t end = pos++;     // old_steps[end] is the walk's sentinel
+        bool rerouted = false;
+        if (cand != cand_end && *cand == w) {
+            cand++;
+            // position j holds s for j == 0 and old_steps[begin + j - 1] after
+            for (size_t j = 0; j <= end - begin && !rerouted; j++) {
+                NodeID x = j == 0 ? s : old_steps[begin + j - 1];
+                if (store.change[x] < 0)
+                    continue;
+                bool moved_on = begin + j < end;
+                if (!moved_on && old_steps[end] != kWalkDangling)
+                    continue;
+                NodeID next = rerouteStep(ds, deg, store, x, moved_on, arcs, groups, rng);
+                if (next == -1)
+                    continue;
+                steps.insert(steps.end(), old_steps.begin() + begin, old_steps.begin() + begin + j);
+                for (size_t k = begin + j; k < end; k++)
+                    up.remove(store, old_steps[k]);
+                steps.push_back(next);
+                up.add(store, next, w);
+                extendWalk(ds, deg, store, next, w, rng, steps, up);
+                rerouted = true;
+            }
+        }
+        if (!rerouted)
+            steps.insert(steps.end(), old_steps.begin() + begin, old_steps.begin() + end + 1);
+    }
+}
+
+template<typename T>
+void dynPPRAlg(T* ds, const EdgeList& el, walk_store& store)
+{
+    std::cout << "Running dynamic Monte Carlo PPR" << std::endl;
+
+    Timer t;
+    t.Start();
+    store.batch++;
+    int64_t old_nodes = store.size();
+    store.resize(ds->num_nodes);
+    degree_view deg = ds->degrees();
+
+    // sources whose out-degree changed, with their arcs in this batch
+    std::vector<std::pair<NodeID, NodeID>> arcs;
+    batchArcs(el, ds->directed, arcs);
+    std::vector<size_t> groups;
+    for (size_t i = 0; i < arcs.size(); i++) {
+        if (i == 0 || arcs[i].first != arcs[i - 1].first)
+            groups.push_back(i);
+    }
+    groups.push_back(arcs.size());
+    std::vector<NodeID> changed;
+    for (size_t g = 0; g + 1 < groups.size(); g++) {
+        NodeID u = arcs[groups[g]].first;
+        if (deg.out_degree(u) != store.degree[u]) {
+            store.change[u] = g;
+            changed.push_back(u);
+        }
+    }
+
+    // walks through the changed sources, grouped by start
+    std::vector<WalkID> cands;
+    #pragma omp parallel
+    {
+        std::vector<WalkID> local;
+        #pragma omp for schedule(dynamic, 16) nowait
+        for (size_t i = 0; i < changed.size(); i++)
+            local.insert(local.end(), store.index[changed[i]].begin(), store.index[changed[i]].end());
+        #pragma omp critical (ppr_candidates)
+        cands.insert(cands.end(), local.begin(), local.end());
+    }
+    std::sort(cands.begin(), cands.end());
+    cands.erase(std::unique(cands.begin(), cands.end()), cands.end());
+
+    // one work item per start: [first candidate, last candidate)
+    std::vector<std::pair<NodeID, std::pair<size_t, size_t>>> work;
+    for (size_t i = 0; i < cands.size();) {
+        NodeID s = cands[i] / kWalksPerVertex;
+        size_t j = i;
+        while (j < cands.size() && static_cast<NodeID>(cands[j] / kWalksPerVertex) == s)
+            j++;
+        work.push_back(std::make_pair(s, std::make_pair(i, j)));
+        i = j;
+    }
+    for (NodeID s = old_nodes; s < ds->num_nodes; s++)
+        work.push_back(std::make_pair(s, std::make_pair(size_t(0), size_t(0))));
+
+    std::vector<std::vector<std::vector<std::pair<NodeID, WalkID>>>> added(omp_get_max_threads());
+    #pragma omp parallel
+    {
+        walk_visits up;
+        #pragma omp for schedule(dynamic, 16) nowait
+        for (size_t i = 0; i < work.size(); i++) {
+            const WalkID* c = cands.data();
+            updateWalks(ds, deg, store, work[i].first, c + work[i].second.first,
+                        c + work[i].second.second, arcs, groups, up);
+        }
+        added[omp_get_thread_num()].swap(up.added);
+    }
+
+    // each partition of the index is filled by one thread
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int p = 0; p < kWalkPartitions; p++) {
+        std::vector<NodeID> touched;
+        for (auto &thread_added : added) {
+            if (thread_added.empty())
+                continue;
+            for (const std::pair<NodeID, WalkID> &a : thread_added[p]) {
+                store.index[a.first].push_back(a.second);
+                touched.push_back(a.first);
+            }
+        }
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (NodeID v : touched) {
+            std::vector<WalkID> &list = store.index[v];
+            if (static_cast<int64_t>(list.size()) <= 2 * store.visits[v] + 8)
+                continue;
+            std::sort(list.begin(), list.end());
+            list.erase(std::unique(list.begin(), list.end()), list.end());
+            list.erase(std::remove_if(list.begin(), list.end(),
+                           [&](WalkID w) { return !store.visits_vertex(w, v); }), list.end());
+        }
+    }
+
+    for (NodeID u : changed) {
+        store.degree[u] = deg.out_degree(u);
+        store.change[u] = -1;
+    }
+
+    t.Stop();
+    ofstream out("Alg.csv", std::ios_base::app);
+    out << t.Seconds() << std::endl;
+    out.close();
+}
+
+// top k vertices by PageRank personalized to s, from s's walks; each walk
+// that moved on to w stands for the average of w's walks from there on
+inline std::vector<std::pair<NodeID, double>> PPRTopK(const walk_store& store, NodeID s, int k)
+{
+    std::unordered_map<NodeID, double> score;
+    if (s < 0 || s >= store.size())
+        return {};
+    const double visit = (1.0 - kDamp) / kWalksPerVertex;
+    const std::vector<NodeID> &steps = store.walks[s];
+    for (size_t pos = 0; pos < steps.size(); pos++) {
+        score[s] += visit;
+        if (steps[pos] < 0)
+            continue;
+        NodeID w = steps[pos];
+        // steps after w in w's own walks, w included
+        for (NodeID x : store.walks[w]) {
+            if (x >= 0)
+                score[x] += visit / kWalksPerVertex;
+        }
+        score[w] += visit;
+        while (steps[pos] >= 0)
+            pos++;
+    }
+    std::vector<std::pair<NodeID, double>> top(score.begin(), score.end());
+    size_t n = std::min(top.size(), static_cast<size_t>(k));
+    std::partial_sort(top.begin(), top.begin() + n, top.end(),
+                      [](const std::pair<NodeID, double>& a, const std::pair<NodeID, double>& b) {
+                          return a.second > b.second || (a.second == b.second && a.first < b.first);
+                      });
+    top.resize(n);
+    return top;
+}
+
+#endif  // DYN_PPR_H_
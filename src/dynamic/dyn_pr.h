@@ -2,8 +2,12 @@
 #define DYN_PR_H_
 
 #include "traversal.h"
+#include "neighbor_block.h"
 #include "../common/timer.h"
 #include "sliding_queue_dynamic.h"
+#include "workspace.h"
+#include "prefetch.h"
+#include "property.h"
 #include "../common/pvector.h"
 #include <cmath>
 #include <iostream>
@@ -14,66 +18,106 @@ typedef float Rank;
 const float kDamp = 0.85;
 const float PRThreshold = 0.0000001;  
 
+// rank share passed to each out-neighbor; sinks pass none
+inline Rank contribution(Rank rank, int64_t out_degree)
+{
+    return out_degree > 0 ? rank / out_degree : 0;
+}
+
+// pulls and pushes the hubs deferred by a round range by range
+template<typename T>
+void PRHubRound(T* ds, vertex_property<Rank>& rank, hub_split& hubs, SlidingQueue<NodeID>& queue,
+                epoch_set& visited, const std::vector<Rank>& outgoing_contrib, Rank base_score)
+{
+    hub_round(ds, hubs, false, Rank(0),
+        [&](const neighbor_block& b) {
+            Rank total = 0;
+            for (int64_t i = 0; i < b.count; i++)
+                total += outgoing_contrib[b.id(i)];
+            return total;
+        },
+        [](Rank a, Rank b) { return a + b; },
+        [&](NodeID n, Rank incoming_total) {
+            Rank old_rank = rank[n];
+            rank[n] = base_score + kDamp * incoming_total;
+            return fabs(rank[n] - old_rank) > PRThreshold;
+        },
+        queue, visited);
+}
+
 template<typename T> 
-void PRIter0(T* ds, SlidingQueue<NodeID>& queue, Rank base_score)
+void PRIter0(T* ds, vertex_property<Rank>& rank, SlidingQueue<NodeID>& queue, algo_workspace& ws, Rank base_score)
 {   
-    pvector<Rank> outgoing_contrib(ds->num_nodes, 0);
-    pvector<bool> visited(ds->num_nodes, false);
-#pragma omp parallel for schedule(dynamic, 64)
-    for(NodeID n=0; n < ds->num_nodes; n++) {    
-        outgoing_contrib[n] = ds->property[n] / (ds->out_degree(n));      
-    }
+    // contributions are cached across batches; only the affected vertices
+    // got new out-edges, and new vertices are affected or have none
+    std::vector<Rank>& outgoing_contrib = ws.scratch;
+    outgoing_contrib.resize(ds->num_nodes, 0);
+    epoch_set& visited = ws.visited;
+    visited.reset(ds->num_nodes);
+    degree_view deg = ds->degrees();
+#pragma omp parallel for
+    for (auto a_iter = ds->affected.begin(); a_iter < ds->affected.end(); a_iter++)
+        outgoing_contrib[*a_iter] = contribution(rank[*a_iter], deg.out_degree(*a_iter));
 
+    hub_split& hubs = ws.hubs;
+    hubs.reset();
 #pragma omp parallel     
     {
         QueueBuffer<NodeID> lqueue(queue);
 #pragma omp for schedule(dynamic, 64)
-        for (NodeID n=0; n < ds->num_nodes; n++) {
-            if (ds->affected[n]) {
-                Rank old_rank = ds->property[n];
-                Rank incoming_total = 0;
-                for(auto v: in_neigh(n, ds)){
-                    incoming_total += outgoing_contrib[v];
-                }
-                    
-                ds->property[n] = base_score + kDamp * incoming_total;                      
-                bool trigger = fabs(ds->property[n] - old_rank) > PRThreshold; 
-                if (trigger) {
-                    //put the out-neighbors into active list 
-                    for (auto v: out_neigh(n, ds)) {                        
-                        bool curr_val = visited[v];
-                        if (!curr_val) {
-                            if (compare_and_swap(visited[v], curr_val, true)) 
-				lqueue.push_back(v);
-                        }
-                    }                                             
-                }    
+        for (auto a_iter = ds->affected.begin(); a_iter < ds->affected.end(); a_iter++) {
+            NodeID n = *a_iter;
+            if (hub_split::is_hub(deg, n)) {
+                hubs.defer(n);
+                continue;
             }
+            Rank old_rank = rank[n];
+            Rank incoming_total = 0;
+            for(auto v: in_neigh(n, ds)){
+                incoming_total += outgoing_contrib[v];
+            }
+                
+            rank[n] = base_score + kDamp * incoming_total;                      
+            bool trigger = fabs(rank[n] - old_rank) > PRThreshold; 
+            if (trigger) {
+                //put the out-neighbors into active list 
+                for (auto v: out_neigh(n, ds)) {                        
+                    if (visited.insert(v))
+                        lqueue.push_back(v);
+                }                                             
+            }    
         }
         lqueue.flush();
     }    
+    PRHubRound(ds, rank, hubs, queue, visited, outgoing_contrib, base_score);
+
+    // only the affected ranks changed, refresh their contributions
+#pragma omp parallel for
+    for (auto a_iter = ds->affected.begin(); a_iter < ds->affected.end(); a_iter++)
+        outgoing_contrib[*a_iter] = contribution(rank[*a_iter], deg.out_degree(*a_iter));
 }
 
 template<typename T>
-void dynPRAlg(T* ds)
+void dynPRAlg(T* ds, vertex_property<Rank>& rank, algo_workspace& ws)
 {     
     std::cout << "Running dynamic PR" << std::endl;  
 
     Timer t;
     t.Start();
+    int64_t old_nodes = rank.size();
+    rank.resize(ds->num_nodes);
 
-    SlidingQueue<NodeID> queue(ds->num_nodes);       
+    SlidingQueue<NodeID>& queue = ws.frontier(ds->num_nodes);       
     const Rank base_score = (1.0f - kDamp)/(ds->num_nodes); 
+    degree_view deg = ds->degrees();
     // set all new vertices' rank to 1/num_nodes, otherwise reuse old values 
 #pragma omp parallel for schedule(dynamic, 64)
-    for (NodeID n = 0; n < ds->num_nodes; n++) {
-        if (ds->property[n] == -1) {
-            ds->property[n] = 1.0f/(ds->num_nodes);
-        }
+    for (NodeID n = old_nodes; n < ds->num_nodes; n++) {
+        rank[n] = 1.0f/(ds->num_nodes);
     } 
 
     // Iteration 0 only on affected vertices    
-    PRIter0(ds, queue, base_score); 
+    PRIter0(ds, rank, queue, ws, base_score); 
     //cout << "Done iter 0" << endl;
     queue.slide_window();
     /*ofstream out("queueSizeParallel.csv", std::ios_base::app);   
@@ -81,14 +125,13 @@ void dynPRAlg(T* ds)
     std::cout << "Queue Size: " << queue.size() << std::endl;
     out.close();*/
     // Iteration 1 onward, process vertices in the queue 
+    // outgoing_contrib is kept up to date for the ranks changed in each round
+    std::vector<Rank>& outgoing_contrib = ws.scratch;
     while (!queue.empty()) {         
         //std::cout << "Not empty queue, Queue Size:" << queue.size() << std::endl;
-        pvector<Rank> outgoing_contrib(ds->num_nodes, 0);
-        pvector<bool> visited(ds->num_nodes, false); 
-        #pragma omp parallel for 
-        for (NodeID n=0; n < ds->num_nodes; n++) { 
-            outgoing_contrib[n] = ds->property[n]/(ds->out_degree(n));      
-        }     
+        epoch_set& visited = ws.visited;
+        visited.reset(ds->num_nodes);
+        ws.hubs.reset();
         #pragma omp parallel 
         {
             QueueBuffer<NodeID> lqueue(queue);   
@@ -96,34 +139,34 @@ void dynPRAlg(T* ds)
             #pragma omp for schedule(dynamic, 64) 
             for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++) {
                 NodeID n = *q_iter;
-                Rank old_rank = ds->property[n];
+                prefetch_frontier(ds, q_iter, queue.end(), true, outgoing_contrib.data());
+                if (hub_split::is_hub(deg, n)) {
+                    ws.hubs.defer(n);
+                    continue;
+                }
+                Rank old_rank = rank[n];
                 Rank incoming_total = 0;
                 for(auto v: in_neigh(n, ds))
                     incoming_total += outgoing_contrib[v];
-                ds->property[n] = base_score + kDamp * incoming_total;                      
-                bool trigger = fabs(ds->property[n] - old_rank) > PRThreshold; 
+                rank[n] = base_score + kDamp * incoming_total;                      
+                bool trigger = fabs(rank[n] - old_rank) > PRThreshold; 
                 if (trigger) {
                     //put the out-neighbors into active list 
                     for (auto v: out_neigh(n, ds)) {
-                        bool curr_val = visited[v];
-                        if (!curr_val) {
-                            if (compare_and_swap(visited[v], curr_val, true)) 
-                                lqueue.push_back(v);
-                        }     
+                        if (visited.insert(v))
+                            lqueue.push_back(v);
                     }     
                 }
             }
             lqueue.flush();
         }
+        PRHubRound(ds, rank, ws.hubs, queue, visited, outgoing_contrib, base_score);
+        #pragma omp parallel for
+        for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++)
+            outgoing_contrib[*q_iter] = contribution(rank[*q_iter], deg.out_degree(*q_iter));
         queue.slide_window();               
     }   
     
-    // clear affected array to get ready for the next update round
-#pragma omp parallel for schedule(dynamic, 64)
-    for (NodeID i = 0; i < ds->num_nodes; i++) {
-        ds->affected[i] = false;
-    }
-
      t.Stop();    
     ofstream out("Alg.csv", std::ios_base::app);   
     out << t.Seconds() << std::endl;    
@@ -132,36 +175,64 @@ void dynPRAlg(T* ds)
 }
 
 template<typename T>
-void PRStartFromScratch(T* ds)
+void PRStartFromScratch(T* ds, vertex_property<Rank>& rank)
 { 
     std::cout << "Running PR from scratch" << std::endl;
 
     Timer t;
     t.Start();
+    rank.resize(ds->num_nodes);
 
     const Rank base_score = (1.0f - kDamp)/(ds->num_nodes);
+    degree_view deg = ds->degrees();
     int max_iters = 10;
     double epsilon = 0.0001;
     // Reset ALL property values 
 #pragma omp parallel for
     for (NodeID n = 0; n < ds->num_nodes; n++) {
-        ds->property[n] = 1.0f / (ds->num_nodes);        
+        rank[n] = 1.0f / (ds->num_nodes);        
     }
     pvector<Rank> outgoing_contrib(ds->num_nodes, 0);
+    // in-neighbor lists of hubs are summed range by range after each sweep
+    hub_split hubs;
+    for (NodeID n = 0; n < ds->num_nodes; n++) {
+        if (deg.in_degree(n) > kHubDegree)
+            hubs.deferred.push_back(n);
+    }
+    hubs.split(ds, hubs.deferred, true);
+    std::vector<Rank> hub_totals;
     for (int iter = 0; iter < max_iters; iter++) {
         double error = 0;
 #pragma omp parallel for
         for (NodeID n = 0; n < ds->num_nodes; n++) { 
-            outgoing_contrib[n] = ds->property[n]/(ds->out_degree(n));      
+            outgoing_contrib[n] = contribution(rank[n], deg.out_degree(n));
         }
 #pragma omp parallel for reduction(+ : error) schedule(dynamic, 64)
         for (NodeID u = 0; u < ds->num_nodes; u++) {
+            if (deg.in_degree(u) > kHubDegree)
+                continue;
             Rank incoming_total = 0;
-            for (NodeID v : in_neigh(u, ds))
-		incoming_total += outgoing_contrib[v];
-            Rank old_rank = ds->property[u];
-            ds->property[u] = base_score + kDamp * incoming_total;
-            error += fabs(ds->property[u] - old_rank);
+            in_neigh_blocks(u, ds, [&](const neighbor_block& b) {
+                for (int64_t i = 0; i < b.count; i++)
+                    incoming_total += outgoing_contrib[b.id(i)];
+            });
+            Rank old_rank = rank[u];
+            rank[u] = base_score + kDamp * incoming_total;
+            error += fabs(rank[u] - old_rank);
+        }
+        reduce_hub_ranges(hubs, hubs.deferred.size(), Rank(0),
+            [&](const neighbor_block& b) {
+                Rank total = 0;
+                for (int64_t i = 0; i < b.count; i++)
+                    total += outgoing_contrib[b.id(i)];
+                return total;
+            },
+            [](Rank a, Rank b) { return a + b; }, hub_totals);
+        for (size_t h = 0; h < hubs.deferred.size(); h++) {
+            NodeID u = hubs.deferred[h];
+            Rank old_rank = rank[u];
+            rank[u] = base_score + kDamp * hub_totals[h];
+            error += fabs(rank[u] - old_rank);
         }
         //std::cout << "Epsilon: "<< epsilon << std::endl;
         //printf(" %2d    %lf\n", iter, error);
@@ -0,0 +1,217 @@
+#ifndef DYN_PRPUSH_H_
+#define DYN_PRPUSH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "traversal.h"
+#include "../common/timer.h"
+#include "sliding_queue_dynamic.h"
+#include "workspace.h"
+#include "property.h"
+#include "dyn_pr.h"
+
+/* Algorithm: Incremental PageRank by residual push
+
+   Every vertex keeps an estimate p and a residual r with the invariant
+
+     r[v] = (1 - kDamp) + kDamp * sum over u->v of p[u] / out_degree(u) - p[v]
+
+   so the PageRank scaled by the vertex count is p plus what the residuals
+   still have to deliver. Pushing u moves r[u] into p[u] and hands
+   kDamp * r[u] / out_degree(u) to each out-neighbor, which keeps the
+   invariant. Scaling by the vertex count keeps (1 - kDamp) fixed as the
+   graph grows, so new vertices do not disturb the others.
+
+   A batch only touches the sources of new edges: p[u] is scaled by
+   new/old out-degree so the old out-neighbors keep their share, r[u] takes
+   the difference and each new out-neighbor gets kDamp * p[u] / out_degree(u).
+   Residuals above kResidualEpsilon are then pushed, so the work follows the
+   size of the change rather than the affected in-neighborhoods.
+
+   Rounds are either deterministic (every vertex pushes the residual it had
+   when the round started) or asynchronous (a vertex pushes whatever has
+   arrived by the time a thread takes it, including pushes from the same
+   round). */
+
+const Rank kResidualEpsilon = 1e-4;    // on scaled ranks, which average 1
+
+struct pr_push_state {
+    vertex_property<Rank> estimate;
+    vertex_property<Rank> residual;
+    std::vector<int64_t> degree;    // out-degree the estimate was last pushed with
+
+    pr_push_state(): estimate(0), residual(1.0f - kDamp) {}
+
+    bool empty() const { return estimate.empty(); }
+};
+
+// (source, destination) of every new directed edge, sorted and unique
+inline void batchArcs(const EdgeList& el, bool directed, std::vector<std::pair<NodeID, NodeID>>& arcs)
+{
+    arcs.clear();
+    for (const Edge& e : el) {
+        arcs.emplace_back(e.source, e.destination);
+        if (!directed)
+            arcs.emplace_back(e.destination, e.source);
+    }
+    std::sort(arcs.begin(), arcs.end());
+    arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+}
+
+// restores the invariant for the batch's sources and new out-neighbors
+template<typename T>
+void PRPushInject(T* ds, const EdgeList& el, pr_push_state& pr, algo_workspace& ws)
+{
+    degree_view deg = ds->degrees();
+    std::vector<std::pair<NodeID, NodeID>> arcs;
+    batchArcs(el, ds->directed, arcs);
+    std::vector<size_t> groups;     // start of each source's arcs
+    for (size_t i = 0; i < arcs.size(); i++) {
+        if (i == 0 || arcs[i].first != arcs[i - 1].first)
+            groups.push_back(i);
+    }
+    groups.push_back(arcs.size());
+
+    // when a batch repeats edges the graph already had, the new ones can't
+    // be told apart; those destinations are recomputed from the invariant
+    epoch_set& recompute = ws.visited;
+    recompute.reset(ds->num_nodes);
+    std::vector<NodeID> rechecked;
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t g = 0; g < groups.size() - 1; g++) {
+        NodeID u = arcs[groups[g]].first;
+        int64_t old_degree = pr.degree[u];
+        int64_t new_degree = deg.out_degree(u);
+        if (new_degree == old_degree)
+            continue;
+        Rank p = pr.estimate[u];
+        Rank scaled = old_degree > 0 ? p * new_degree / old_degree : p;
+        pr.estimate[u] = scaled;
+        pr.degree[u] = new_degree;
+        atomic_add(pr.residual[u], p - scaled);
+        bool all_new = static_cast<int64_t>(groups[g + 1] - groups[g]) == new_degree - old_degree;
+        for (size_t i = groups[g]; i < groups[g + 1]; i++) {
+            NodeID v = arcs[i].second;
+            if (all_new) {
+                atomic_add(pr.residual[v], kDamp * scaled / new_degree);
+            } else if (recompute.insert(v)) {
+                #pragma omp critical (prpush_recheck)
+                rechecked.push_back(v);
+            }
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < rechecked.size(); i++) {
+        NodeID v = rechecked[i];
+        Rank incoming_total = 0;
+        for (auto u: in_neigh(v, ds))
+            incoming_total += contribution(pr.estimate[u], deg.out_degree(u));
+        pr.residual[v] = (1.0f - kDamp) + kDamp * incoming_total - pr.estimate[v];
+    }
+}
+
+// moves taken into u's estimate and pushes it to u's out-neighbors
+template<typename T>
+void PRPushVertex(T* ds, pr_push_state& pr, NodeID u, Rank taken, epoch_set& visited,
+                  QueueBuffer<NodeID>& lqueue)
+{
+    pr.estimate[u] += taken;
+    int64_t out_degree = pr.degree[u];
+    if (out_degree == 0)
+        return;
+    Rank share = kDamp * taken / out_degree;
+    for (auto v: out_neigh(u, ds)) {
+        Rank old_residual = atomic_add(pr.residual[v], share);
+        if (std::fabs(old_residual + share) > kResidualEpsilon && visited.insert(v))
+            lqueue.push_back(v);
+    }
+}
+
+template<typename T>
+void dynPRPushAlg(T* ds, const EdgeList& el, pr_push_state& pr, bool async, algo_workspace& ws)
+{
+    std::cout << "Running dynamic PR push (" << (async ? "asynchronous" : "deterministic") << ")" << std::endl;
+
+    Timer t;
+    t.Start();
+    int64_t old_nodes = pr.estimate.size();
+    pr.estimate.resize(ds->num_nodes);
+    pr.residual.resize(ds->num_nodes);
+    if (static_cast<int64_t>(pr.degree.size()) < ds->num_nodes)
+        pr.degree.resize(ds->num_nodes, 0);
+
+    SlidingQueue<NodeID>& queue = ws.frontier(ds->num_nodes);
+    PRPushInject(ds, el, pr, ws);
+
+    // new vertices start with their whole rank as residual
+    epoch_set& visited = ws.visited;
+    visited.reset(ds->num_nodes);
+    #pragma omp parallel
+    {
+        QueueBuffer<NodeID> lqueue(queue);
+        #pragma omp for schedule(dynamic, 64) nowait
+        for (auto a_iter = ds->affected.begin(); a_iter < ds->affected.end(); a_iter++) {
+            if (std::fabs(pr.residual[*a_iter]) > kResidualEpsilon && visited.insert(*a_iter))
+                lqueue.push_back(*a_iter);
+        }
+        #pragma omp for schedule(dynamic, 64) nowait
+        for (NodeID n = old_nodes; n < ds->num_nodes; n++) {
+            if (visited.insert(n))
+                lqueue.push_back(n);
+        }
+        lqueue.flush();
+    }
+    queue.slide_window();
+
+    std::vector<Rank>& taken = ws.scratch;
+    while (!queue.empty()) {
+        visited.reset(ds->num_nodes);
+        if (!async) {
+            // residuals as of the start of the round
+            taken.resize(queue.size());
+            #pragma omp parallel for
+            for (size_t i = 0; i < queue.size(); i++) {
+                NodeID u = queue.begin()[i];
+                taken[i] = pr.residual[u];
+                if (std::fabs(taken[i]) > kResidualEpsilon)
+                    pr.residual[u] = 0;
+                else
+                    taken[i] = 0;
+            }
+        }
+        #pragma omp parallel
+        {
+            QueueBuffer<NodeID> lqueue(queue);
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t i = 0; i < queue.size(); i++) {
+                NodeID u = queue.begin()[i];
+                Rank r;
+                if (async) {
+                    if (std::fabs(pr.residual[u]) <= kResidualEpsilon)
+                        continue;
+                    r = atomic_exchange(pr.residual[u], Rank(0));
+                } else {
+                    r = taken[i];
+                    if (r == 0)
+                        continue;
+                }
+                PRPushVertex(ds, pr, u, r, visited, lqueue);
+            }
+            lqueue.flush();
+        }
+        queue.slide_window();
+    }
+
+    t.Stop();
+    ofstream out("Alg.csv", std::ios_base::app);
+    out << t.Seconds() << std::endl;
+    out.close();
+}
+
+#endif  // DYN_PRPUSH_H_
@@ -7,73 +7,110 @@
 
 #include "traversal.h"
 #include "sliding_queue_dynamic.h"
+#include "workspace.h"
+#include "prefetch.h"
+#include "property.h"
 #include "../common/timer.h"
 #include "../common/pvector.h"
 
 /* Algorithm: Incremental SSSP and SSSP from scratch */
 
+typedef int64_t Distance;   // sums of integer weights, -1 for new vertices
+const Distance kDistanceInf = std::numeric_limits<Distance>::max() / 2;
+
+// pulls and pushes the hubs deferred by a round range by range
+template<typename T>
+void SSSPHubRound(T* ds, vertex_property<Distance>& dist, hub_split& hubs, SlidingQueue<NodeID>& queue,
+                  epoch_set& visited){
+    hub_round(ds, hubs, false, kDistanceInf,
+        [&](const neighbor_block& b){
+            Distance new_path = kDistanceInf;
+            for(int64_t i = 0; i < b.count; i++)
+                new_path = std::min(new_path, dist[b.id(i)] + b.weight(i));
+            return new_path;
+        },
+        [](Distance a, Distance b){ return std::min(a, b); },
+        [&](NodeID n, Distance new_path){
+            if((new_path < dist[n]) && (new_path != kDistanceInf)){
+                dist[n] = new_path;
+                return true;
+            }
+            return false;
+        },
+        queue, visited);
+}
+
 template<typename T> 
-void SSSPIter0(T* ds, SlidingQueue<NodeID>& queue){   
-    pvector<bool> visited(ds->num_nodes, false);   
+void SSSPIter0(T* ds, vertex_property<Distance>& dist, SlidingQueue<NodeID>& queue, algo_workspace& ws){   
+    epoch_set& visited = ws.visited;
+    visited.reset(ds->num_nodes);
+    degree_view deg = ds->degrees();
+    hub_split& hubs = ws.hubs;
+    hubs.reset();
 
     #pragma omp parallel     
     {
         QueueBuffer<NodeID> lqueue(queue);
         #pragma omp for schedule(dynamic, 64)
-        for(NodeID n=0; n < ds->num_nodes; n++){
-            if(ds->affected[n]){                
-                float old_path = ds->property[n];
-                float new_path = kDistInf;
-                
-                neighborhood<T> neigh = in_neigh(n, ds);
-                                 
-                // pull new depth from incoming neighbors
-                for(neighborhood_iter<T> it = neigh.begin(); it != neigh.end(); it++){                    
-                    new_path = std::min(new_path, ds->property[*it] + it.extractWeight());
-                }      
-
-                bool trigger = (((new_path < old_path) && (new_path != kDistInf)));                 
-
-                if(trigger){                   
-                    ds->property[n] = new_path; 
-                    //put the out-neighbors into active list 
-                    for(auto v: out_neigh(n, ds)){                        
-                        bool curr_val = visited[v];
-                        if(!curr_val){
-                            if(compare_and_swap(visited[v], curr_val, true)) 
-                                 lqueue.push_back(v);
-                        }                       
-                    }                                                 
-                }        
+        for(auto a_iter = ds->affected.begin(); a_iter < ds->affected.end(); a_iter++){
+            NodeID n = *a_iter;
+            if(hub_split::is_hub(deg, n)){
+                hubs.defer(n);
+                continue;
             }
+            Distance old_path = dist[n];
+            Distance new_path = kDistanceInf;
+            
+            neighborhood<T> neigh = in_neigh(n, ds);
+                             
+            // pull new depth from incoming neighbors
+            for(neighborhood_iter<T> it = neigh.begin(); it != neigh.end(); it++){                    
+                new_path = std::min(new_path, dist[*it] + it.extractWeight());
+            }      
+
+            bool trigger = (((new_path < old_path) && (new_path != kDistanceInf)));                 
+
+            if(trigger){                   
+                dist[n] = new_path; 
+                //put the out-neighbors into active list 
+                for(auto v: out_neigh(n, ds)){                        
+                    if(visited.insert(v))
+                        lqueue.push_back(v);
+                }                                                 
+            }        
         }
         lqueue.flush();
     }    
+    SSSPHubRound(ds, dist, hubs, queue, visited);
 }
 
 template<typename T> 
-void dynSSSPAlg(T* ds, NodeID source){    
+void dynSSSPAlg(T* ds, vertex_property<Distance>& dist, NodeID source, algo_workspace& ws){    
     std::cout << "Running dynamic SSSP" << std::endl;
     Timer t;
     t.Start();
+    dist.resize(ds->num_nodes);
 
-    SlidingQueue<NodeID> queue(ds->num_nodes);       
+    SlidingQueue<NodeID>& queue = ws.frontier(ds->num_nodes);       
     
     // set all new vertices' rank to inf, otherwise reuse old values 
     #pragma omp parallel for schedule(dynamic, 64)
     for(NodeID n = 0; n < ds->num_nodes; n++){
-        if(ds->property[n] == -1){
-            if(n == source) ds->property[n] = 0;
-            else ds->property[n] = kDistInf;
+        if(dist[n] == -1){
+            if(n == source) dist[n] = 0;
+            else dist[n] = kDistanceInf;
         }
     }      
 
-    SSSPIter0(ds, queue); 
+    SSSPIter0(ds, dist, queue, ws); 
     queue.slide_window();
     
     while(!queue.empty()){         
         //std::cout << "Not empty queue, Queue Size:" << queue.size() << std::endl;        
-        pvector<bool> visited(ds->num_nodes, false); 
+        epoch_set& visited = ws.visited;
+        visited.reset(ds->num_nodes);
+        degree_view deg = ds->degrees();
+        ws.hubs.reset();
 
         #pragma omp parallel 
         {
@@ -81,42 +118,39 @@ void dynSSSPAlg(T* ds, NodeID source){
             #pragma omp for schedule(dynamic, 64)
             for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
                 NodeID n = *q_iter;
+                prefetch_frontier(ds, q_iter, queue.end(), true, &dist[0]);
+                if(hub_split::is_hub(deg, n)){
+                    ws.hubs.defer(n);
+                    continue;
+                }
 
-                float old_path = ds->property[n];
-                float new_path = kDistInf;
+                Distance old_path = dist[n];
+                Distance new_path = kDistanceInf;
                 
                 neighborhood<T> neigh = in_neigh(n, ds);
                                  
                 // pull new depth from incoming neighbors
                 for(neighborhood_iter<T> it = neigh.begin(); it != neigh.end(); it++){                    
-                    new_path = std::min(new_path, ds->property[*it] + it.extractWeight());
+                    new_path = std::min(new_path, dist[*it] + it.extractWeight());
                 }      
                 
                 // valid depth + lower than before = trigger 
-                bool trigger = (((new_path < old_path) && (new_path != kDistInf)));     
+                bool trigger = (((new_path < old_path) && (new_path != kDistanceInf)));     
 
                 if(trigger){           
-                    ds->property[n] = new_path;        
+                    dist[n] = new_path;        
                     for(auto v: out_neigh(n, ds)){
-                        bool curr_val = visited[v];
-                        if(!curr_val){
-                            if(compare_and_swap(visited[v], curr_val, true)) 
-                                lqueue.push_back(v);
-                        }            
+                        if(visited.insert(v))
+                            lqueue.push_back(v);
                     }         
                 }
             }
             lqueue.flush();
         }
+        SSSPHubRound(ds, dist, ws.hubs, queue, visited);
         queue.slide_window();                 
     }     
     
-    // clear affected array to get ready for the next update round
-    #pragma omp parallel for schedule(dynamic, 64)
-    for(NodeID i = 0; i < ds->num_nodes; i++){
-        ds->affected[i] = false;
-    }         
-
     t.Stop();    
     ofstream out("Alg.csv", std::ios_base::app);   
     out << t.Seconds() << std::endl;    
@@ -124,18 +158,19 @@ void dynSSSPAlg(T* ds, NodeID source){
 }
 
 template<typename T> 
-void SSSPStartFromScratch(T* ds, NodeID source, float delta){ 
+void SSSPStartFromScratch(T* ds, vertex_property<Distance>& dist, NodeID source, float delta){ 
     std::cout <<"Running SSSP from scratch" << std::endl;
 
     Timer t;
     t.Start();
+    dist.resize(ds->num_nodes);
 
     int num_edges_directed = ds->directed ? ds->num_edges : 2*ds->num_edges;
     
     #pragma omp parallel for 
     for(NodeID n = 0; n < ds->num_nodes; n++)
-        ds->property[n] = kDistInf;    
-    ds->property[source] = 0;
+        dist[n] = kDistanceInf;    
+    dist[source] = 0;
 
     pvector<NodeID> frontier(num_edges_directed);
 
@@ -157,27 +192,16 @@ void SSSPStartFromScratch(T* ds, NodeID source, float delta){
             #pragma omp for nowait schedule(dynamic, 64)
             for (size_t i=0; i < curr_frontier_tail; i++) {
                 NodeID u = frontier[i];
-                if (ds->property[u] >= delta * static_cast<float>(curr_bin_index)) {
+                if (dist[u] >= delta * static_cast<float>(curr_bin_index)) {
                     neighborhood<T> neigh = out_neigh(u, ds);
                     for(neighborhood_iter<T> it = neigh.begin(); it != neigh.end(); it++){                    
-                        float old_dist = ds->property[*it];
-                        float new_dist = ds->property[u] + it.extractWeight();
-                        if (new_dist < old_dist) {
-                            bool changed_dist = true;
-                            while (!compare_and_swap(ds->property[*it], old_dist, new_dist)){
-                                old_dist = ds->property[*it];
-                                if (old_dist <= new_dist) {
-                                    changed_dist = false;
-                                    break;
-                                }
-                            }
-                            if (changed_dist) {
-                                size_t dest_bin = new_dist/delta;
-                                if (dest_bin >= local_bins.size()) {
-                                    local_bins.resize(dest_bin+1);
-                                }
-                                local_bins[dest_bin].push_back(*it);
+                        Distance new_dist = dist[u] + it.extractWeight();
+                        if (atomic_min(dist[*it], new_dist)) {
+                            size_t dest_bin = new_dist/delta;
+                            if (dest_bin >= local_bins.size()) {
+                                local_bins.resize(dest_bin+1);
                             }
+                            local_bins[dest_bin].push_back(*it);
                         }
                     }
                 }
@@ -6,83 +6,121 @@
 
 #include "traversal.h"
 #include "sliding_queue_dynamic.h"
+#include "workspace.h"
+#include "prefetch.h"
+#include "property.h"
 #include "../common/pvector.h"
 
 /* Algorithm: Incremental SSWP and SSWP from scratch. 
 This is the bottleneck shortest path problem. 
 */
 
+typedef int64_t Width;  // bottleneck of integer weights, -1 for new vertices
+const Width kWidthInf = std::numeric_limits<Width>::max();
+
+// pulls and pushes the hubs deferred by a round range by range; an empty
+// in-neighborhood pulls width 0, which never triggers
+template<typename T>
+void SSWPHubRound(T* ds, vertex_property<Width>& width, hub_split& hubs, SlidingQueue<NodeID>& queue,
+                  epoch_set& visited){
+    hub_round(ds, hubs, false, Width(0),
+        [&](const neighbor_block& b){
+            Width new_path = 0;
+            for(int64_t i = 0; i < b.count; i++)
+                new_path = std::max(new_path, std::min(width[b.id(i)], static_cast<Width>(b.weight(i))));
+            return new_path;
+        },
+        [](Width a, Width b){ return std::max(a, b); },
+        [&](NodeID n, Width new_path){
+            if(new_path > width[n]){
+                width[n] = new_path;
+                return true;
+            }
+            return false;
+        },
+        queue, visited);
+}
+
 template<typename T> 
-void SSWPIter0(T* ds, SlidingQueue<NodeID>& queue){   
-    pvector<bool> visited(ds->num_nodes, false);   
+void SSWPIter0(T* ds, vertex_property<Width>& width, SlidingQueue<NodeID>& queue, algo_workspace& ws){   
+    epoch_set& visited = ws.visited;
+    visited.reset(ds->num_nodes);
+    degree_view deg = ds->degrees();
+    hub_split& hubs = ws.hubs;
+    hubs.reset();
 
     #pragma omp parallel     
     {
         QueueBuffer<NodeID> lqueue(queue);
         #pragma omp for schedule(dynamic, 64)
-        for(NodeID n=0; n < ds->num_nodes; n++){
-            if(ds->affected[n]){                
-                float old_path = ds->property[n];
-                std::vector<float> arr;                
-                
-                neighborhood<T> neigh = in_neigh(n, ds);
-                float temp;
-                                 
-                // prepare arr vector 
-                for(neighborhood_iter<T> it = neigh.begin(); it != neigh.end(); it++){                    
-                    temp = std::min(ds->property[*it], static_cast<float>(it.extractWeight()));
-                    arr.push_back(temp);
-                }      
+        for(auto a_iter = ds->affected.begin(); a_iter < ds->affected.end(); a_iter++){
+            NodeID n = *a_iter;
+            if(hub_split::is_hub(deg, n)){
+                hubs.defer(n);
+                continue;
+            }
+            Width old_path = width[n];
+            std::vector<Width> arr;                
+            
+            neighborhood<T> neigh = in_neigh(n, ds);
+            Width temp;
+                             
+            // prepare arr vector 
+            for(neighborhood_iter<T> it = neigh.begin(); it != neigh.end(); it++){                    
+                temp = std::min(width[*it], static_cast<Width>(it.extractWeight()));
+                arr.push_back(temp);
+            }      
 
-                if(!arr.empty()){
-                    // find max in arr vector 
-                    float new_path = arr[0];
-                    for(std::vector<float>::iterator it = arr.begin(); it!=arr.end(); it++){
-                        new_path = std::max(new_path, *it);
-                    }
+            if(!arr.empty()){
+                // find max in arr vector 
+                Width new_path = arr[0];
+                for(std::vector<Width>::iterator it = arr.begin(); it!=arr.end(); it++){
+                    new_path = std::max(new_path, *it);
+                }
 
-                    bool trigger = (new_path > old_path);        
+                bool trigger = (new_path > old_path);        
 
-                    if(trigger){
-                        ds->property[n] = new_path;
-                        for(auto v: out_neigh(n, ds)){ 
-                            bool curr_val = visited[v];
-                            if(!curr_val){
-                                if(compare_and_swap(visited[v], curr_val, true)) 
-                                    lqueue.push_back(v);
-                            }                       
-                        }                                                 
-                    }
-                }                   
-            }
+                if(trigger){
+                    width[n] = new_path;
+                    for(auto v: out_neigh(n, ds)){ 
+                        if(visited.insert(v))
+                            lqueue.push_back(v);
+                    }                                                 
+                }
+            }                   
         }
         lqueue.flush();
     }    
+    SSWPHubRound(ds, width, hubs, queue, visited);
 }
 
 template<typename T> 
-void dynSSWPAlg(T* ds, NodeID source){    
+void dynSSWPAlg(T* ds, vertex_property<Width>& width, NodeID source, algo_workspace& ws){    
     std::cout << "Running dynamic SSWP" << std::endl;
     Timer t;
     t.Start();
+    width.resize(ds->num_nodes);
 
-    SlidingQueue<NodeID> queue(ds->num_nodes);       
+    SlidingQueue<NodeID>& queue = ws.frontier(ds->num_nodes);       
     
     // set all new vertices' rank to inf, otherwise reuse old values 
     #pragma omp parallel for schedule(dynamic, 64)
     for(NodeID n = 0; n < ds->num_nodes; n++){
-        if(ds->property[n] == -1){
-            if(n == source) ds->property[n] = kDistInf;
-            else ds->property[n] = 0;
+        if(width[n] == -1){
+            if(n == source) width[n] = kWidthInf;
+            else width[n] = 0;
         }
     }      
 
-    SSWPIter0(ds, queue); 
+    SSWPIter0(ds, width, queue, ws); 
     queue.slide_window();
     
     while(!queue.empty()){         
         //std::cout << "Not empty queue, Queue Size:" << queue.size() << std::endl;        
-        pvector<bool> visited(ds->num_nodes, false); 
+        epoch_set& visited = ws.visited;
+        visited.reset(ds->num_nodes);
+        degree_view deg = ds->degrees();
+        ws.hubs.reset();
 
         #pragma omp parallel 
         {
@@ -90,50 +128,47 @@ void dynSSWPAlg(T* ds, NodeID source){
             #pragma omp for schedule(dynamic, 64)
             for (auto q_iter = queue.begin(); q_iter < queue.end(); q_iter++){
                 NodeID n = *q_iter;
-                float old_path = ds->property[n];      
-                std::vector<float> arr;                
+                prefetch_frontier(ds, q_iter, queue.end(), true, &width[0]);
+                if(hub_split::is_hub(deg, n)){
+                    ws.hubs.defer(n);
+                    continue;
+                }
+                Width old_path = width[n];      
+                std::vector<Width> arr;                
                 
                 neighborhood<T> neigh = in_neigh(n, ds);
-                float temp;
+                Width temp;
                                  
                 // prepare arr vector 
                 for(neighborhood_iter<T> it = neigh.begin(); it != neigh.end(); it++){                    
-                    temp = std::min(ds->property[*it], static_cast<float>(it.extractWeight()));
+                    temp = std::min(width[*it], static_cast<Width>(it.extractWeight()));
                     arr.push_back(temp);
                 }
 
                 if(!arr.empty()){
                     // find max in arr vector 
-                    float new_path = arr[0];
-                    for(std::vector<float>::iterator it = arr.begin(); it!=arr.end(); it++){
+                    Width new_path = arr[0];
+                    for(std::vector<Width>::iterator it = arr.begin(); it!=arr.end(); it++){
                         new_path = std::max(new_path, *it);
                     }
                     
                     bool trigger = (new_path > old_path);        
 
                     if(trigger){
-                        ds->property[n] = new_path;                         
+                        width[n] = new_path;                         
                         for(auto v: out_neigh(n, ds)){ 
-                            bool curr_val = visited[v];
-                            if(!curr_val){
-                                if(compare_and_swap(visited[v], curr_val, true)) 
-                                    lqueue.push_back(v);
-                            }                       
+                            if(visited.insert(v))
+                                lqueue.push_back(v);
                         }                                                 
                     }
                 }                
             }
             lqueue.flush();
         }
+        SSWPHubRound(ds, width, ws.hubs, queue, visited);
         queue.slide_window();                 
     }   
   
-    // clear affected array to get ready for the next update round
-    #pragma omp parallel for schedule(dynamic, 64)
-    for(NodeID i = 0; i < ds->num_nodes; i++){
-        ds->affected[i] = false;
-    }      
-
     t.Stop();    
     ofstream out("Alg.csv", std::ios_base::app);   
     out << t.Seconds() << std::endl;    
@@ -141,16 +176,17 @@ void dynSSWPAlg(T* ds, NodeID source){
 }
 
 template<typename T> 
-void SSWPStartFromScratch(T* ds, NodeID source){ 
+void SSWPStartFromScratch(T* ds, vertex_property<Width>& width, NodeID source){ 
     std::cout <<"Running SSWP from scratch" << std::endl;
 
     Timer t;
     t.Start();
+    width.resize(ds->num_nodes);
 
     #pragma omp parallel for 
     for(NodeID n = 0; n < ds->num_nodes; n++)
-        ds->property[n] = 0;
-    ds->property[source] = kDistInf;   
+        width[n] = 0;
+    width[source] = kWidthInf;   
 
     SlidingQueue<NodeID> queue(ds->num_nodes);   
     queue.push_back(source);
@@ -169,8 +205,8 @@ void SSWPStartFromScratch(T* ds, NodeID source){
                 neighborhood<T> neigh = out_neigh(u, ds);
                 for(neighborhood_iter<T> it = neigh.begin(); it != neigh.end(); it++){ 
                     NodeID v = *it;
-                    float old_dist = ds->property[v];
-                    float new_dist = std::min(ds->property[u], static_cast<float>(it.extractWeight()));
+                    Width old_dist = width[v];
+                    Width new_dist = std::min(width[u], static_cast<Width>(it.extractWeight()));
 
                     if (new_dist > old_dist){
                         bool curr_val = visited[v];
@@ -178,11 +214,7 @@ void SSWPStartFromScratch(T* ds, NodeID source){
                             if(compare_and_swap(visited[v], curr_val, true))
                                     lqueue.push_back(v);
                         }
-                        
-                        while (!compare_and_swap(ds->property[v], old_dist, new_dist)){
-                            old_dist = ds->property[v];
-                            if (old_dist >= new_dist) break;                            
-                        }                                             
+                        atomic_max(width[v], new_dist);
                     }
                 }                
             }
@@ -0,0 +1,434 @@
+#ifndef EDGELOG_H_
+#define EDGELOG_H_
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "abstract_data_struc.h"
+#include "stinger_atomics.h"
+#include "print.h"
+
+/* Append-only edge log with background archiving (GraphOne style).
+
+   update() only appends the batch to a circular edge log and links every
+   edge into the per-vertex tail chains of its endpoints, O(1) per edge. An
+   archiver thread moves logged ranges into per-vertex adjacency lists made
+   of chunks that double in size; existing entries never move, so readers
+   can walk a list while the archiver appends to it.
+
+   Readers see the archived adjacency merged with the part of the log that
+   is not archived yet. update() caches that tail, sorted, for every vertex
+   it touches, along with the merged degree, so readers never walk the log
+   and degree queries are O(1). The archiver may move cached tail entries
+   into the lists afterwards, so an edge can show up in both; the tail is
+   deduplicated against the archived entries and wins, since it holds the
+   newest weight. update() blocks only when the log is full. */
+
+bool compare_and_swap(bool &x, const bool &old_val, const bool &new_val);
+
+struct log_edge {
+    NodeID src;
+    NodeID dst;
+    Weight weight;
+};
+
+template <typename T>
+struct log_chunk {
+    T* edges;
+    int64_t capacity;
+    log_chunk* next;
+    explicit log_chunk(int64_t cap): edges(new T[cap]), capacity(cap), next(nullptr) {}
+    ~log_chunk() { delete[] edges; }
+};
+
+template <typename T>
+struct archived_list {
+    log_chunk<T>* first = nullptr;
+    log_chunk<T>* last = nullptr;
+    int64_t last_begin = 0;     // index of the first entry in last
+    int64_t length = 0;         // published entries, read with acquire
+};
+
+// one direction (out or in) of the graph
+template <typename T>
+class log_side {
+public:
+    static const int64_t first_chunk_edges = 8;
+    static const int64_t max_chunk_edges = 4096;
+
+    std::vector<archived_list<T>> lists;
+    // tail chains link log endpoints: 2 * position + (0 for the source, 1 for
+    // the destination), so both ends of an undirected edge can be chained
+    std::vector<int64_t> tail_head;     // newest endpoint per vertex, -1 if none
+    std::vector<int64_t> tail_next;     // older endpoint of the same vertex, per endpoint slot
+    // written by update() only, while no reader is active
+    std::vector<std::vector<T>> tails;  // unarchived neighbors as of the last update, sorted by ID
+    std::vector<NodeID> tailed;         // vertices with a non-empty cached tail
+    std::vector<int64_t> degrees;       // archived and tail neighbors, without duplicates
+
+    log_side(int64_t n, int64_t log_capacity):
+        lists(n), tail_head(n, -1), tail_next(2 * log_capacity, -1), tails(n), degrees(n, 0) {}
+    bool has_tail(NodeID u, int64_t mark) const { return tail_head[u] >= 2 * mark; }
+    ~log_side();
+    int64_t length(NodeID u) const { return __atomic_load_n(&lists[u].length, __ATOMIC_ACQUIRE); }
+    void archive(NodeID u, std::vector<T> &fresh);
+};
+
+template <typename T>
+log_side<T>::~log_side()
+{
+    for (archived_list<T> &l : lists) {
+        for (log_chunk<T>* c = l.first; c != nullptr; ) {
+            log_chunk<T>* next = c->next;
+            delete c;
+            c = next;
+        }
+    }
+}
+
+/* Merge fresh (sorted by ID, duplicate-free) into u's list: entries already
+   archived take the new weight, the rest are appended. Only the archiver
+   calls this, at most once per vertex at a time. */
+template <typename T>
+void log_side<T>::archive(NodeID u, std::vector<T> &fresh)
+{
+    archived_list<T> &l = lists[u];
+    std::vector<char> seen(fresh.size(), 0);
+    int64_t idx = 0;
+    auto by_id = [](const T &a, const T &b) { return a.getNodeID() < b.getNodeID(); };
+    for (log_chunk<T>* c = l.first; c != nullptr && idx < l.length; c = c->next) {
+        for (int64_t k = 0; k < c->capacity && idx < l.length; k++, idx++) {
+            auto it = std::lower_bound(fresh.begin(), fresh.end(), c->edges[k], by_id);
+            if (it != fresh.end() && it->getNodeID() == c->edges[k].getNodeID()) {
+                c->edges[k] = *it;
+                seen[it - fresh.begin()] = 1;
+            }
+        }
+    }
+    int64_t len = l.length;
+    for (size_t i = 0; i < fresh.size(); i++) {
+        if (seen[i])
+            continue;
+        if (l.last == nullptr || len - l.last_begin == l.last->capacity) {
+            int64_t cap = l.last ? l.last->capacity * 2 : first_chunk_edges;
+            if (cap > max_chunk_edges)
+                cap = max_chunk_edges;
+            log_chunk<T>* c = new log_chunk<T>(cap);
+            if (l.last)
+                __atomic_store_n(&l.last->next, c, __ATOMIC_RELEASE);
+            else
+                __atomic_store_n(&l.first, c, __ATOMIC_RELEASE);
+            l.last_begin = len;
+            l.last = c;
+        }
+        l.last->edges[len - l.last_begin] = fresh[i];
+        len++;
+    }
+    __atomic_store_n(&l.length, len, __ATOMIC_RELEASE);
+}
+
+template <typename T>
+class edgeLog: public dataStruc {
+    private:
+      int64_t num_nodes_initialize;
+      const int64_t log_capacity;       // power of two
+      std::vector<log_edge> log;
+      int64_t head = 0;                 // edges appended so far
+      int64_t archived = 0;             // edges archived so far, read with acquire
+      int64_t num_archive_rounds = 0;
+
+      std::thread archiver;
+      std::mutex log_mutex;
+      std::condition_variable log_filled, log_drained;
+      bool stop = false;
+
+      void processMetaData(const Edge& e, bool source);
+      void link_tail(log_side<T> &side, NodeID u, int64_t link);
+      void archive_loop();
+      void archive_range(int64_t first, int64_t last);
+      void collect_tail(const log_side<T> &side, NodeID u, int64_t mark, std::vector<T> &tail) const;
+      void refresh(log_side<T> &side, std::vector<NodeID> &touched);
+
+    public:
+      log_side<T> out;
+      log_side<T> in;     // only filled for directed graphs
+      edgeLog(bool w, bool d, int64_t _num_nodes, int64_t _log_capacity = int64_t(1) << 20);
+      ~edgeLog();
+      void update(const EdgeList& el) override;
+      void print() override;
+      int64_t in_degree(NodeID n) override;
+      int64_t out_degree(NodeID n) override;
+
+      int64_t archived_mark() const { return __atomic_load_n(&archived, __ATOMIC_ACQUIRE); }
+};
+
+template <typename T>
+edgeLog<T>::edgeLog(bool w, bool d, int64_t _num_nodes, int64_t _log_capacity):
+    dataStruc(w, d),
+    num_nodes_initialize(_num_nodes),
+    log_capacity(_log_capacity),
+    log(_log_capacity),
+    out(_num_nodes, _log_capacity),
+    in(d ? _num_nodes : 0, d ? _log_capacity : 0)
+{
+    assert(log_capacity > 0 && !(log_capacity & (log_capacity - 1)));
+    affected.resize(num_nodes_initialize);
+    archiver = std::thread(&edgeLog<T>::archive_loop, this);
+}
+
+template <typename T>
+edgeLog<T>::~edgeLog()
+{
+    {
+        std::lock_guard<std::mutex> guard(log_mutex);
+        stop = true;
+    }
+    log_filled.notify_one();
+    archiver.join();
+}
+
+template <typename T>
+void edgeLog<T>::processMetaData(const Edge& e, bool source)
+{
+    bool exists = source ? e.sourceExists : e.destExists;
+    NodeID v = source ? e.source : e.destination;
+
+    affected.insert(v);
+
+    if (!exists)
+        stinger_int64_fetch_add(&num_nodes, 1);
+    stinger_int64_fetch_add(&num_edges, 1);
+}
+
+template <typename T>
+void edgeLog<T>::link_tail(log_side<T> &side, NodeID u, int64_t link)
+{
+    int64_t prev = __sync_lock_test_and_set(&side.tail_head[u], link);
+    side.tail_next[link & (2 * log_capacity - 1)] = prev;
+}
+
+template <typename T>
+void edgeLog<T>::update(const EdgeList& el)
+{
+    int64_t done = 0;
+    int64_t total = el.size();
+    while (done < total) {
+        // wait for the archiver to free enough of the log
+        int64_t room;
+        {
+            std::unique_lock<std::mutex> lock(log_mutex);
+            log_drained.wait(lock, [&]() { return head - archived_mark() < log_capacity; });
+            room = std::min(total - done, log_capacity - (head - archived_mark()));
+        }
+        int64_t start = head;
+        #pragma omp parallel for
+        for (int64_t k = 0; k < room; k++) {
+            const Edge &e = el[done + k];
+            int64_t pos = start + k;
+            log[pos & (log_capacity - 1)] = log_edge{e.source, e.destination, e.weight};
+            processMetaData(e, true);
+            processMetaData(e, false);
+            link_tail(out, e.source, 2 * pos);
+            if (directed)
+                link_tail(in, e.destination, 2 * pos + 1);
+            else
+                link_tail(out, e.destination, 2 * pos + 1);
+        }
+        {
+            std::lock_guard<std::mutex> guard(log_mutex);
+            head += room;
+        }
+        log_filled.notify_one();
+        done += room;
+    }
+
+    std::vector<NodeID> out_touched, in_touched;
+    for (const Edge &e : el) {
+        out_touched.push_back(e.source);
+        if (directed)
+            in_touched.push_back(e.destination);
+        else
+            out_touched.push_back(e.destination);
+    }
+    refresh(out, out_touched);
+    if (directed)
+        refresh(in, in_touched);
+}
+
+template <typename T>
+void edgeLog<T>::archive_loop()
+{
+    for (;;) {
+        int64_t first, last;
+        {
+            std::unique_lock<std::mutex> lock(log_mutex);
+            log_filled.wait(lock, [&]() { return stop || head > archived; });
+            if (stop)
+                return;
+            first = archived;
+            last = head;
+        }
+        archive_range(first, last);
+        {
+            std::lock_guard<std::mutex> guard(log_mutex);
+            __atomic_store_n(&archived, last, __ATOMIC_RELEASE);
+        }
+        log_drained.notify_all();
+        num_archive_rounds++;
+    }
+}
+
+template <typename T>
+void edgeLog<T>::archive_range(int64_t first, int64_t last)
+{
+    typedef std::pair<NodeID, T> keyed;
+    std::vector<keyed> out_edges, in_edges;
+    for (int64_t pos = first; pos < last; pos++) {
+        const log_edge &e = log[pos & (log_capacity - 1)];
+        T nb;
+        nb.setInfo(e.dst, e.weight);
+        out_edges.emplace_back(e.src, nb);
+        nb.setInfo(e.src, e.weight);
+        if (directed)
+            in_edges.emplace_back(e.dst, nb);
+        else
+            out_edges.emplace_back(e.dst, nb);
+    }
+
+    auto archive_side = [](log_side<T> &side, std::vector<keyed> &edges) {
+        // stable, so the last copy of a duplicate edge is the latest one
+        std::stable_sort(edges.begin(), edges.end(), [](const keyed &a, const keyed &b) {
+            return a.first != b.first ? a.first < b.first
+                                      : a.second.getNodeID() < b.second.getNodeID();
+        });
+        std::vector<size_t> group_start;
+        for (size_t i = 0; i < edges.size(); i++) {
+            if (i == 0 || edges[i].first != edges[i - 1].first)
+                group_start.push_back(i);
+        }
+        int64_t num_groups = group_start.size();
+        group_start.push_back(edges.size());
+
+        #pragma omp parallel for schedule(dynamic, 16)
+        for (int64_t g = 0; g < num_groups; g++) {
+            std::vector<T> fresh;
+            for (size_t i = group_start[g]; i < group_start[g + 1]; i++) {
+                if (i + 1 < group_start[g + 1] &&
+                    edges[i + 1].second.getNodeID() == edges[i].second.getNodeID())
+                    continue;
+                fresh.push_back(edges[i].second);
+            }
+            side.archive(edges[group_start[g]].first, fresh);
+        }
+    };
+    archive_side(out, out_edges);
+    if (directed)
+        archive_side(in, in_edges);
+}
+
+/* Neighbors of u logged at or after mark, newest copy of each, sorted by ID.
+   The chain is only ordered between batches (edges of one batch are linked
+   in parallel), so copies are ordered by their log position. */
+template <typename T>
+void edgeLog<T>::collect_tail(const log_side<T> &side, NodeID u, int64_t mark, std::vector<T> &tail) const
+{
+    std::vector<std::pair<int64_t, T>> found;
+    for (int64_t link = side.tail_head[u]; link >= 2 * mark;
+         link = side.tail_next[link & (2 * log_capacity - 1)]) {
+        const log_edge &e = log[(link >> 1) & (log_capacity - 1)];
+        T nb;
+        nb.setInfo(link & 1 ? e.src : e.dst, e.weight);
+        found.emplace_back(link, nb);
+    }
+    std::sort(found.begin(), found.end(), [](const std::pair<int64_t, T> &a, const std::pair<int64_t, T> &b) {
+        return a.second.getNodeID() != b.second.getNodeID() ? a.second.getNodeID() < b.second.getNodeID()
+                                                            : a.first > b.first;
+    });
+    tail.clear();
+    for (size_t i = 0; i < found.size(); i++) {
+        if (i == 0 || found[i].second.getNodeID() != found[i - 1].second.getNodeID())
+            tail.push_back(found[i].second);
+    }
+}
+
+/* Re-caches the tail and degree of each touched vertex, once per batch
+   however often it appears, and drops cached tails the archiver has fully
+   caught up with. The mark is read before the lengths, so an edge archived
+   in between is in both and only counted once. */
+template <typename T>
+void edgeLog<T>::refresh(log_side<T> &side, std::vector<NodeID> &touched)
+{
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    int64_t mark = archived_mark();
+
+    std::vector<NodeID> tailed;
+    for (NodeID u : side.tailed) {
+        if (side.has_tail(u, mark))
+            tailed.push_back(u);
+        else
+            std::vector<T>().swap(side.tails[u]);
+    }
+
+    auto by_id = [](const T &a, const T &b) { return a.getNodeID() < b.getNodeID(); };
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (size_t i = 0; i < touched.size(); i++) {
+        NodeID u = touched[i];
+        std::vector<T> &tail = side.tails[u];
+        tail.clear();
+        if (side.has_tail(u, mark))
+            collect_tail(side, u, mark, tail);
+        int64_t len = side.length(u);
+        int64_t deg = len + tail.size();
+        int64_t idx = 0;
+        for (log_chunk<T>* c = side.lists[u].first; c != nullptr && idx < len && !tail.empty(); c = c->next) {
+            for (int64_t k = 0; k < c->capacity && idx < len; k++, idx++) {
+                if (std::binary_search(tail.begin(), tail.end(), c->edges[k], by_id))
+                    deg--;
+            }
+        }
+        side.degrees[u] = deg;
+    }
+
+    for (NodeID u : touched) {
+        if (!side.tails[u].empty())
+            tailed.push_back(u);
+    }
+    std::sort(tailed.begin(), tailed.end());
+    tailed.erase(std::unique(tailed.begin(), tailed.end()), tailed.end());
+    side.tailed.swap(tailed);
+}
+
+template <typename T>
+int64_t edgeLog<T>::in_degree(NodeID n)
+{
+    return directed ? in.degrees[n] : out.degrees[n];
+}
+
+template <typename T>
+int64_t edgeLog<T>::out_degree(NodeID n)
+{
+    return out.degrees[n];
+}
+
+template <typename T>
+void edgeLog<T>::print()
+{
+    std::cout << " numNodes: " << num_nodes <<
+            " numEdges: " << num_edges <<
+            " weighted: " << weighted <<
+            " directed: " << directed <<
+            " logCapacity: " << log_capacity <<
+            " loggedEdges: " << head <<
+            " archivedEdges: " << archived_mark() <<
+            " archiveRounds: " << num_archive_rounds <<
+    std::endl;
+}
+
+#endif  // EDGELOG_H_
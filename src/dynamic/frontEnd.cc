@@ -24,8 +24,8 @@ int main(int argc, char* argv[])
     
     EdgeBatchQueue queue;
     bool loop = true;  
-    dataStruc* struc = createDataStruc(opts.type, opts.weighted, opts.directed, opts.num_nodes, opts.num_threads);    
-    std::thread t1(dequeAndInsertEdge, opts.type, struc, &queue, &q_lock, opts.algorithm, &loop);   
+    dataStruc* struc = createDataStruc(opts.type, opts.weighted, opts.directed, opts.num_nodes, opts.num_threads, opts.edges_per_block, opts.ld_threshold);    
+    std::thread t1(dequeAndInsertEdge, opts.type, struc, &queue, &q_lock, opts.algorithms, opts.csr_snapshot, opts.ppr_top_k, &loop);   
     
     cpu_set_t cpuset;
     CPU_ZERO(&cpuset);
@@ -0,0 +1,197 @@
+#ifndef HUB_SPLIT_H_
+#define HUB_SPLIT_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "neighbor_block.h"
+#include "sliding_queue_dynamic.h"
+
+/* Edge-parallel processing of hub vertices.
+
+   Frontier loops hand out vertices to threads in chunks of 64, so a vertex
+   with millions of neighbors keeps one thread busy while the others wait at
+   the barrier. Kernels defer such hubs from their vertex loop instead, then
+   cut the hubs' neighbor lists into ranges of at most kHubGrain edges and
+   share the ranges among all threads: reduce_hub_ranges() for pulls,
+   push_hub_ranges() for pushes into the frontier.
+
+   Ranges point straight into the data structure where neighbor lists are
+   stored in contiguous runs (see contiguous_blocks); for the other
+   structures the hub's neighbors are copied into the split first. */
+
+const int64_t kHubDegree = 8192;   // neighbor lists above this are split
+const int64_t kHubGrain = 1024;    // edges per range
+
+// true if for_each_neighbor_block() hands out blocks that stay valid after
+// the callback returns, rather than a reused copy buffer
+template <typename T>
+struct contiguous_blocks { static const bool value = false; };
+
+template <typename U>
+struct contiguous_blocks<adList<U>> { static const bool value = true; };
+
+template <typename U>
+struct contiguous_blocks<adListShared<U>> { static const bool value = true; };
+
+template <typename U>
+struct contiguous_blocks<adListChunked<U>> { static const bool value = true; };
+
+template <typename U>
+struct contiguous_blocks<csrDelta<U>> { static const bool value = true; };
+
+template <typename U>
+struct contiguous_blocks<csrGraph<U>> { static const bool value = true; };
+
+template <>
+struct contiguous_blocks<stinger> { static const bool value = true; };
+
+struct hub_range {
+    int64_t hub;            // index into the vertex list given to split()
+    neighbor_block block;
+    int64_t copy_start;     // offset into the copy buffers, -1 if block points into ds
+};
+
+class hub_split {
+    std::vector<hub_range> ranges;
+    std::vector<NodeID> copied_ids;
+    std::vector<Weight> copied_weights;
+
+    void cut(int64_t hub, const neighbor_block& b, int64_t copy_start) {
+        for (int64_t i = 0; i < b.count; i += kHubGrain) {
+            int64_t count = std::min(kHubGrain, b.count - i);
+            neighbor_block part{b.ids ? b.ids + i * b.stride : nullptr,
+                                b.weights ? b.weights + i * b.stride : nullptr, count, b.stride};
+            ranges.push_back(hub_range{hub, part, copy_start < 0 ? -1 : copy_start + i});
+        }
+    }
+
+public:
+    std::vector<NodeID> deferred;   // hubs skipped by the vertex loop
+    std::vector<NodeID> active;     // deferred hubs whose value changed
+
+    // the vertex loop must not touch n itself
+    static bool is_hub(const degree_view& deg, NodeID n) {
+        return deg.in_degree(n) > kHubDegree || deg.out_degree(n) > kHubDegree;
+    }
+
+    // thread-safe
+    void defer(NodeID n) {
+        #pragma omp critical (hub_split_defer)
+        deferred.push_back(n);
+    }
+
+    void reset() {
+        deferred.clear();
+        active.clear();
+        clear_ranges();
+    }
+
+    void clear_ranges() {
+        ranges.clear();
+        copied_ids.clear();
+        copied_weights.clear();
+    }
+
+    // appends the ranges of vs[h]'s in- or out-neighbors, tagged with h
+    template <typename T>
+    void split(T* ds, const std::vector<NodeID>& vs, bool in_neigh) {
+        bool in = in_neigh && ds->directed;
+        for (size_t h = 0; h < vs.size(); h++) {
+            if (contiguous_blocks<T>::value) {
+                for_each_neighbor_block(ds, vs[h], in, [&](const neighbor_block& b) {
+                    cut(h, b, -1);
+                });
+            } else {
+                int64_t start = copied_ids.size();
+                for_each_neighbor_block(ds, vs[h], in, [&](const neighbor_block& b) {
+                    for (int64_t i = 0; i < b.count; i++) {
+                        copied_ids.push_back(b.id(i));
+                        copied_weights.push_back(b.weight(i));
+                    }
+                });
+                int64_t count = copied_ids.size() - start;
+                cut(h, neighbor_block{nullptr, nullptr, count, 1}, start);
+            }
+        }
+    }
+
+    int64_t num_ranges() const { return ranges.size(); }
+
+    int64_t hub(int64_t r) const { return ranges[r].hub; }
+
+    neighbor_block range(int64_t r) const {
+        const hub_range &hr = ranges[r];
+        if (hr.copy_start < 0)
+            return hr.block;
+        return neighbor_block{copied_ids.data() + hr.copy_start,
+                              copied_weights.data() + hr.copy_start, hr.block.count, 1};
+    }
+};
+
+// totals[h] = combine over vs[h]'s ranges of range_value(block), starting at identity
+template <typename R, typename F, typename C>
+void reduce_hub_ranges(const hub_split& split, int64_t num_hubs, R identity,
+                       F range_value, C combine, std::vector<R>& totals)
+{
+    std::vector<R> partial(split.num_ranges());
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int64_t r = 0; r < split.num_ranges(); r++)
+        partial[r] = range_value(split.range(r));
+    totals.assign(num_hubs, identity);
+    for (int64_t r = 0; r < split.num_ranges(); r++)
+        totals[split.hub(r)] = combine(totals[split.hub(r)], partial[r]);
+}
+
+// calls f(block, lqueue) on every range, lqueue feeding queue's next window
+template <typename F>
+void push_hub_ranges(const hub_split& split, SlidingQueue<NodeID>& queue, F f)
+{
+    #pragma omp parallel
+    {
+        QueueBuffer<NodeID> lqueue(queue);
+        #pragma omp for schedule(dynamic, 16) nowait
+        for (int64_t r = 0; r < split.num_ranges(); r++)
+            f(split.range(r), lqueue);
+        lqueue.flush();
+    }
+}
+
+// Finishes a propagation round for the deferred hubs: pulls over their
+// in-neighbors (and out-neighbors if both), calls update(n, total), which
+// returns true if n's value changed, and queues the out-neighbors (and
+// in-neighbors if both) of changed hubs not yet in visited.
+template <typename T, typename R, typename F, typename C, typename A, typename S>
+void hub_round(T* ds, hub_split& hubs, bool both, R identity, F range_value, C combine,
+               A update, SlidingQueue<NodeID>& queue, S& visited)
+{
+    if (hubs.deferred.empty())
+        return;
+    std::vector<R> totals;
+    hubs.clear_ranges();
+    hubs.split(ds, hubs.deferred, true);
+    if (both)
+        hubs.split(ds, hubs.deferred, false);
+    reduce_hub_ranges(hubs, hubs.deferred.size(), identity, range_value, combine, totals);
+
+    hubs.active.clear();
+    for (size_t h = 0; h < hubs.deferred.size(); h++) {
+        if (update(hubs.deferred[h], totals[h]))
+            hubs.active.push_back(hubs.deferred[h]);
+    }
+    if (hubs.active.empty())
+        return;
+    hubs.clear_ranges();
+    hubs.split(ds, hubs.active, false);
+    if (both)
+        hubs.split(ds, hubs.active, true);
+    push_hub_ranges(hubs, queue, [&](const neighbor_block& b, QueueBuffer<NodeID>& lqueue) {
+        for (int64_t i = 0; i < b.count; i++) {
+            if (visited.insert(b.id(i)))
+                lqueue.push_back(b.id(i));
+        }
+    });
+}
+
+#endif  // HUB_SPLIT_H_
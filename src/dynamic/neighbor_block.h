@@ -0,0 +1,310 @@
+#ifndef NEIGHBOR_BLOCK_H_
+#define NEIGHBOR_BLOCK_H_
+
+#include <cstddef>
+#include <type_traits>
+
+#include "traversal.h"
+
+/* Block-wise neighbor access.
+
+   out_neigh_blocks(n, ds, f) and in_neigh_blocks(n, ds, f) call f once per
+   contiguous run of neighbors: the whole vector of an adList, every edge
+   block of stinger, the base slice and each delta range of csrDelta. Inside
+   a block the IDs (and weights) sit at a fixed stride, so the kernel's inner
+   loop is a plain counted loop with no iterator state to advance. Structures
+   without contiguous runs (darhh, pcsr, adListCompressed, edgeLog) are copied
+   through neighborhood_iter into a small buffer and handed out in chunks.
+   f may return bool; false stops the walk after that block.
+
+   nth_neighbor(ds, n, in_neigh, j) picks the j-th neighbor directly where
+   the layout allows it and stops at the j-th entry everywhere else. */
+
+struct neighbor_block {
+    const NodeID* ids;
+    const Weight* weights;  // nullptr for unweighted entries
+    int64_t count;
+    int64_t stride;         // distance between consecutive IDs (and weights)
+
+    NodeID id(int64_t i) const { return ids[i * stride]; }
+    Weight weight(int64_t i) const { return weights ? weights[i * stride] : -1; }
+};
+
+inline neighbor_block make_block(const Node* first, int64_t count)
+{
+    return neighbor_block{&first->node, nullptr, count, 1};
+}
+
+inline neighbor_block make_block(const NodeWeight* first, int64_t count)
+{
+    const int64_t stride = sizeof(NodeWeight) / sizeof(NodeID);
+    return neighbor_block{&first->node, &first->weight, count, stride};
+}
+
+// false if f asked to stop; callbacks returning void never do
+template <typename F>
+bool visit_block(F& f, const neighbor_block& b, std::true_type)
+{
+    return f(b);
+}
+
+template <typename F>
+bool visit_block(F& f, const neighbor_block& b, std::false_type)
+{
+    f(b);
+    return true;
+}
+
+template <typename F>
+bool visit_block(F& f, const neighbor_block& b)
+{
+    return visit_block(f, b, std::is_same<decltype(f(b)), bool>());
+}
+
+template <typename U, typename F>
+void for_each_vector_block(const std::vector<U>& neighbors, F& f)
+{
+    if (!neighbors.empty())
+        visit_block(f, make_block(neighbors.data(), neighbors.size()));
+}
+
+// fallback: copy through the iterator, kBufferedBlock neighbors at a time
+const int64_t kBufferedBlock = 64;
+
+template <typename T, typename F>
+void for_each_neighbor_block(T* ds, NodeID n, bool in_neigh, F f)
+{
+    NodeID ids[kBufferedBlock];
+    Weight weights[kBufferedBlock];
+    int64_t count = 0;
+    neighborhood<T> neigh(n, ds, in_neigh);
+    for (neighborhood_iter<T> it = neigh.begin(); it != neigh.end(); it++) {
+        ids[count] = *it;
+        weights[count] = it.extractWeight();
+        if (++count == kBufferedBlock) {
+            if (!visit_block(f, neighbor_block{ids, weights, count, 1}))
+                return;
+            count = 0;
+        }
+    }
+    if (count > 0)
+        visit_block(f, neighbor_block{ids, weights, count, 1});
+}
+
+template <typename U, typename F>
+void for_each_neighbor_block(adList<U>* ds, NodeID n, bool in_neigh, F f)
+{
+    for_each_vector_block(in_neigh ? ds->in_neighbors[n] : ds->out_neighbors[n], f);
+}
+
+template <typename U, typename F>
+void for_each_neighbor_block(adListShared<U>* ds, NodeID n, bool in_neigh, F f)
+{
+    for_each_vector_block(in_neigh ? ds->in_neighbors[n] : ds->out_neighbors[n], f);
+}
+
+template <typename U, typename F>
+void for_each_neighbor_block(adListChunked<U>* ds, NodeID n, bool in_neigh, F f)
+{
+    for_each_vector_block(ds->neighbors(n, in_neigh), f);
+}
+
+template <typename U, typename F>
+void for_each_neighbor_block(csrDelta<U>* ds, NodeID n, bool in_neigh, F f)
+{
+    csr_delta_store<U> &s = in_neigh ? ds->in : ds->out;
+    int64_t base_count = s.base->offsets[n + 1] - s.base->offsets[n];
+    if (base_count > 0 &&
+        !visit_block(f, make_block(s.base->neighbors.data() + s.base->offsets[n], base_count)))
+        return;
+    for (const delta_range<U> &r : s.ranges[n]) {
+        if (r.end != r.begin && !visit_block(f, make_block(r.begin, r.end - r.begin)))
+            return;
+    }
+}
+
+template <typename U, typename F>
+void for_each_neighbor_block(csrGraph<U>* ds, NodeID n, bool in_neigh, F f)
+{
+    const csr_snapshot<U> &s = in_neigh ? ds->in : ds->out;
+    int64_t count = s.offsets[n + 1] - s.offsets[n];
+    if (count > 0)
+        visit_block(f, make_block(s.neighbors.data() + s.offsets[n], count));
+}
+
+// stinger keeps IDs and weights in separate arrays per edge block
+template <typename F>
+void for_each_neighbor_block(stinger* ds, NodeID n, bool in_neigh, F f)
+{
+    stinger_vertex &sv = ds->vertices[n];
+    for (stinger_eb* eb = in_neigh ? sv.in_neighbors : sv.out_neighbors; eb != nullptr; eb = eb->next) {
+        if (eb->numEdges > 0 &&
+            !visit_block(f, neighbor_block{eb->neighbors, eb->weights, eb->numEdges, 1}))
+            return;
+    }
+}
+
+// first contiguous run of n's neighbors without walking the rest; empty for
+// structures that have no such run
+template <typename T>
+neighbor_block first_neighbor_block(T* ds, NodeID n, bool in_neigh)
+{
+    (void)ds; (void)n; (void)in_neigh;
+    return neighbor_block{nullptr, nullptr, 0, 1};
+}
+
+template <typename U>
+neighbor_block first_neighbor_block(adList<U>* ds, NodeID n, bool in_neigh)
+{
+    const std::vector<U> &v = in_neigh ? ds->in_neighbors[n] : ds->out_neighbors[n];
+    return make_block(v.data(), v.size());
+}
+
+template <typename U>
+neighbor_block first_neighbor_block(adListShared<U>* ds, NodeID n, bool in_neigh)
+{
+    const std::vector<U> &v = in_neigh ? ds->in_neighbors[n] : ds->out_neighbors[n];
+    return make_block(v.data(), v.size());
+}
+
+template <typename U>
+neighbor_block first_neighbor_block(adListChunked<U>* ds, NodeID n, bool in_neigh)
+{
+    const std::vector<U> &v = ds->neighbors(n, in_neigh);
+    return make_block(v.data(), v.size());
+}
+
+template <typename U>
+neighbor_block first_neighbor_block(csrDelta<U>* ds, NodeID n, bool in_neigh)
+{
+    csr_delta_store<U> &s = in_neigh ? ds->in : ds->out;
+    return make_block(s.base->neighbors.data() + s.base->offsets[n],
+                      s.base->offsets[n + 1] - s.base->offsets[n]);
+}
+
+template <typename U>
+neighbor_block first_neighbor_block(csrGraph<U>* ds, NodeID n, bool in_neigh)
+{
+    const csr_snapshot<U> &s = in_neigh ? ds->in : ds->out;
+    return make_block(s.neighbors.data() + s.offsets[n], s.offsets[n + 1] - s.offsets[n]);
+}
+
+inline neighbor_block first_neighbor_block(stinger* ds, NodeID n, bool in_neigh)
+{
+    stinger_eb* eb = in_neigh ? ds->vertices[n].in_neighbors : ds->vertices[n].out_neighbors;
+    if (eb == nullptr)
+        return neighbor_block{nullptr, nullptr, 0, 1};
+    return neighbor_block{eb->neighbors, eb->weights, eb->numEdges, 1};
+}
+
+// j-th neighbor of n in iteration order, -1 if n has no more than j neighbors;
+// the fallback stops at entry j instead of walking the whole list
+template <typename T>
+NodeID nth_neighbor(T* ds, NodeID n, bool in_neigh, int64_t j)
+{
+    NodeID found = -1;
+    for_each_neighbor_block(ds, n, in_neigh, [&](const neighbor_block& b) {
+        if (j < b.count) {
+            found = b.id(j);
+            return false;
+        }
+        j -= b.count;
+        return true;
+    });
+    return found;
+}
+
+template <typename U>
+NodeID nth_vector_neighbor(const std::vector<U>& neighbors, int64_t j)
+{
+    return j < (int64_t) neighbors.size() ? neighbors[j].getNodeID() : -1;
+}
+
+template <typename U>
+NodeID nth_neighbor(adList<U>* ds, NodeID n, bool in_neigh, int64_t j)
+{
+    return nth_vector_neighbor(in_neigh ? ds->in_neighbors[n] : ds->out_neighbors[n], j);
+}
+
+template <typename U>
+NodeID nth_neighbor(adListShared<U>* ds, NodeID n, bool in_neigh, int64_t j)
+{
+    return nth_vector_neighbor(in_neigh ? ds->in_neighbors[n] : ds->out_neighbors[n], j);
+}
+
+template <typename U>
+NodeID nth_neighbor(adListChunked<U>* ds, NodeID n, bool in_neigh, int64_t j)
+{
+    return nth_vector_neighbor(ds->neighbors(n, in_neigh), j);
+}
+
+// index the base slice, then skip delta ranges by their length
+template <typename U>
+NodeID nth_neighbor(csrDelta<U>* ds, NodeID n, bool in_neigh, int64_t j)
+{
+    csr_delta_store<U> &s = in_neigh ? ds->in : ds->out;
+    int64_t base_count = s.base->offsets[n + 1] - s.base->offsets[n];
+    if (j < base_count)
+        return s.base->neighbors[s.base->offsets[n] + j].getNodeID();
+    j -= base_count;
+    for (const delta_range<U> &r : s.ranges[n]) {
+        if (j < r.end - r.begin)
+            return r.begin[j].getNodeID();
+        j -= r.end - r.begin;
+    }
+    return -1;
+}
+
+template <typename U>
+NodeID nth_neighbor(csrGraph<U>* ds, NodeID n, bool in_neigh, int64_t j)
+{
+    const csr_snapshot<U> &s = in_neigh ? ds->in : ds->out;
+    if (j >= s.offsets[n + 1] - s.offsets[n])
+        return -1;
+    return s.neighbors[s.offsets[n] + j].getNodeID();
+}
+
+// n's entries are contiguous from vertex_start apart from the gap at the end
+// of each leaf, so only the leaves before the j-th entry are visited
+template <typename U>
+NodeID nth_neighbor(pcsr<U>* ds, NodeID n, bool in_neigh, int64_t j)
+{
+    pma<U> &p = in_neigh ? ds->in : ds->out;
+    if (j >= p.degree[n])
+        return -1;
+    int64_t slot = p.vertex_start[n];
+    while (true) {
+        int64_t leaf = slot >> pma<U>::leaf_bits;
+        int64_t live = (leaf << pma<U>::leaf_bits) + p.count[leaf] - slot;
+        if (j < live)
+            return p.nbs[slot + j].getNodeID();
+        j -= live;
+        slot = (leaf + 1) << pma<U>::leaf_bits;
+    }
+}
+
+// skip whole edge blocks by their edge count
+inline NodeID nth_neighbor(stinger* ds, NodeID n, bool in_neigh, int64_t j)
+{
+    stinger_vertex &sv = ds->vertices[n];
+    for (stinger_eb* eb = in_neigh ? sv.in_neighbors : sv.out_neighbors; eb != nullptr; eb = eb->next) {
+        if (j < eb->numEdges)
+            return eb->neighbors[j];
+        j -= eb->numEdges;
+    }
+    return -1;
+}
+
+template <typename T, typename F>
+void out_neigh_blocks(NodeID n, T* ds, F f)
+{
+    for_each_neighbor_block(ds, n, false, f);
+}
+
+template <typename T, typename F>
+void in_neigh_blocks(NodeID n, T* ds, F f)
+{
+    for_each_neighbor_block(ds, n, ds->directed, f);
+}
+
+#endif  // NEIGHBOR_BLOCK_H_
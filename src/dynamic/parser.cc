@@ -20,21 +20,39 @@ std::string getSuffix(std::string filename)
 
 bool supportedAlg(const std::string& alg)
 {
-    std::array<std::string, 13> algs = {
+    std::array<std::string, 19> algs = {
 	"traverse",
 	"prfromscratch", "prdyn",
 	"ccfromscratch", "ccdyn",
 	"mcfromscratch", "mcdyn",
 	"ssspfromscratch", "ssspdyn",
 	"bfsfromscratch", "bfsdyn",
-	"sswpfromscratch", "sswpdyn"
+	"sswpfromscratch", "sswpdyn",
+	"msbfsfromscratch", "msbfsdyn",
+	"prpushdyn", "prpushasyncdyn",
+	"pprdyn", "ccufdyn"
     };	
     return std::find(algs.begin(), algs.end(), alg) != algs.end();
 }
 
+// "prdyn,ccdyn" -> {"prdyn", "ccdyn"}
+std::vector<std::string> splitAlgs(const std::string &list)
+{
+    std::vector<std::string> algs;
+    size_t start = 0;
+    while (true) {
+	size_t comma = list.find(',', start);
+	algs.push_back(list.substr(start, comma - start));
+	if (comma == std::string::npos)
+	    break;
+	start = comma + 1;
+    }
+    return algs;
+}
+
 bool supportedDataStruc(const std::string &type)
 {
-    return (type== "adList" || type == "adListShared" || type == "degAwareRHH" || type == "stinger" || type == "adListChunked");
+    return (type== "adList" || type == "adListShared" || type == "degAwareRHH" || type == "stinger" || type == "adListChunked" || type == "csrDelta" || type == "pcsr" || type == "adListCompressed" || type == "edgeLog");
 }
 
 void printUsage()
@@ -48,14 +66,22 @@ void printUsage()
 	      << "-d directed       0=undirected   1=directed\n"
 	      << "-s dataStructure  data structure to use (default: adList)\n"
 		  << "-n max number of nodes  to initialize with\n"
-	      << "-a algorithm      algorithm to run (default: traverse)\n"
+	      << "-a algorithm      algorithm(s) to run, comma separated (default: traverse)\n"
 	      << "-t number of threads      (default: 16)\n"
+	      << "-e edges per stinger edge block      (default: 16)\n"
+	      << "-l degAwareRHH low-degree threshold      (default: 0 = tuned per partition)\n"
+	      << "-c csrSnapshot    1=run from-scratch algorithms on a CSR snapshot rebuilt after every update (default: 0)\n"
+	      << "-k topK           pprdyn: print the top k vertices by PageRank personalized to the source after the last batch (default: 0)\n"
 	      << "  DATA STRUCTURE OPTIONS:\n"
 		  << "               1) adList (single-threaded) \n"		  
 	      << "               2) adListShared (multihtreaded shared style) \n"
 		  << "               3) adListChunked (multithreaded chunk style) \n"
 	      << "               4) degAwareRHH (multithreaded chunk style) \n"
 	      << "               5) stinger (multihtreaded shared style)\n"
+	      << "               6) csrDelta (CSR base + per-batch delta log)\n"
+	      << "               7) pcsr (packed memory array)\n"
+	      << "               8) adListCompressed (delta/varint encoded blocks)\n"
+	      << "               9) edgeLog (append-only edge log, archived in the background)\n"
 	      << "  ALGORITHM OPTIONS: \n"
 	      << "               1) traverse\n"
 	      << "               2) prfromscratch\n"
@@ -69,7 +95,14 @@ void printUsage()
 	      << "               10) ssspfromscratch\n"
 	      << "               11) ssspdyn\n"
 	      << "               12) sswpfromscratch\n"
-	      << "               13) sswpdyn"
+	      << "               13) sswpdyn\n"
+	      << "               14) msbfsfromscratch (BFS from up to 64 landmarks)\n"
+	      << "               15) msbfsdyn\n"
+	      << "               16) prpushdyn (PR by residual push, deterministic rounds)\n"
+	      << "               17) prpushasyncdyn (PR by residual push, asynchronous rounds)\n"
+	      << "               18) pprdyn (Monte Carlo PR and personalized PR from stored random walks)\n"
+	      << "               19) ccufdyn (CC by union-find over each batch's edges, insert-only)\n"
+	      << "  Several algorithms (e.g. -a prdyn,ccdyn) run one after another on every batch"
 	      << std::endl; 
 }
 
@@ -77,7 +110,7 @@ cmd_args parse(int argc, char *argv[])
 {
     cmd_args args;
     int opt = 0;
-    while(-1 != (opt = getopt(argc, argv, "f:b:w:d:s:n:a:t:h"))) {
+    while(-1 != (opt = getopt(argc, argv, "f:b:w:d:s:n:a:t:e:l:c:k:h"))) {
         switch(opt) {
 	case 'f':               
 	    if (getSuffix(optarg) != ".csv") {
@@ -129,14 +162,51 @@ cmd_args parse(int argc, char *argv[])
 	case 't':
 	    args.num_threads = atoi(optarg);    
 	    break;
-	case 'a':
-	    args.algorithm = optarg;                  
-	    if (!supportedAlg(args.algorithm)) {
-		std::cout << "Unsupported Algorithm" << std::endl;
+	case 'e':
+	    args.edges_per_block = atoi(optarg);
+	    if (args.edges_per_block <= 0) {
+		std::cout << "Edges per block must be positive" << std::endl;
+		printUsage();
+		exit(-1);
+	    }
+	    break;
+	case 'l':
+	    args.ld_threshold = atoi(optarg);
+	    if (args.ld_threshold < 0) {
+		std::cout << "Low-degree threshold must not be negative" << std::endl;
+		printUsage();
+		exit(-1);
+	    }
+	    break;
+	case 'c':
+	    if(atoi(optarg) == 1) {
+		args.csr_snapshot = true;
+	    } else if (atoi(optarg) == 0) {
+		args.csr_snapshot = false;
+	    } else {
+		std::cout << "CSR snapshot only takes 0 or 1" << std::endl;
+		printUsage();
+		exit(-1);
+	    }
+	    break;
+	case 'k':
+	    args.ppr_top_k = atoi(optarg);
+	    if (args.ppr_top_k < 0) {
+		std::cout << "Top k must not be negative" << std::endl;
 		printUsage();
 		exit(-1);
 	    }
 	    break;
+	case 'a':
+	    args.algorithms = splitAlgs(optarg);
+	    for (const std::string &alg : args.algorithms) {
+		if (!supportedAlg(alg)) {
+		    std::cout << "Unsupported Algorithm " << alg << std::endl;
+		    printUsage();
+		    exit(-1);
+		}
+	    }
+	    break;
 	case 'h':
 	    std::cout << "Printing help" << std::endl;
 	    printUsage();
@@ -177,10 +247,12 @@ cmd_args parse(int argc, char *argv[])
 
     std::array<std::string, 4> reqs = {
 	"ssspdyn", "ssspfromscratch", "sswpdyn", "sswpfromscratch"};
-    bool requires_weighted = std::find(reqs.begin(), reqs.end(), args.algorithm) != reqs.end();
-    if (!args.weighted && requires_weighted) {
-        std::cout << "ERROR! " << args.algorithm << " requires weighted graph " << std::endl;
-        exit(-1);
+    for (const std::string &alg : args.algorithms) {
+	bool requires_weighted = std::find(reqs.begin(), reqs.end(), alg) != reqs.end();
+	if (!args.weighted && requires_weighted) {
+	    std::cout << "ERROR! " << alg << " requires weighted graph " << std::endl;
+	    exit(-1);
+	}
     }
     return args;
 }
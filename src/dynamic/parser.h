@@ -2,6 +2,7 @@
 #define PARSER_H
 
 #include <string>
+#include <vector>
 
 struct cmd_args {
     int batch_size = 0;
@@ -10,13 +11,18 @@ struct cmd_args {
     int64_t num_nodes = 0;
     std::string filename;
     std::string type = "adList";
-    std::string algorithm = "traverse";
+    std::vector<std::string> algorithms = {"traverse"};
     int8_t flags = 0;
     int64_t num_threads = 16; // default
+    int64_t edges_per_block = 16; // stinger only
+    int64_t ld_threshold = 0;     // degAwareRHH only, 0 = auto-tuned
+    bool csr_snapshot = false;    // from-scratch algorithms run on a CSR copy
+    int ppr_top_k = 0;            // pprdyn only, 0 = don't print
 };
 
 std::string getSuffix(std::string filename);
 bool supportedAlg(const std::string &alg);
+std::vector<std::string> splitAlgs(const std::string &list);
 bool supportedDataStruc(const std::string &type);
 void printUsage();
 cmd_args parse(int argc, char *argv[]);
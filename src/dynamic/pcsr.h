@@ -0,0 +1,482 @@
+#ifndef PCSR_H_
+#define PCSR_H_
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "abstract_data_struc.h"
+#include "stinger_atomics.h"
+#include "print.h"
+
+/* Packed CSR: all edges of one direction live in a single packed memory array
+   (PMA), sorted by (source, neighbor) with gaps left for future inserts.
+
+   The array is cut into leaves of leaf_size slots; the live entries of a leaf
+   are packed to its left and every leaf holds at least one entry once the
+   array is non-empty. Leaves form an implicit binary tree. A batch is merged
+   straight into the leaves it falls into; a leaf that would overflow is
+   resolved by redistributing the smallest enclosing window whose density
+   stays under the bound of its level (1.0 at the leaves down to 0.75 at the
+   root), and the array doubles once the root itself is too dense. That gives
+   amortized O(log^2 n) moves per edge and neighbor lists that are sorted and
+   contiguous apart from the gaps at the end of each leaf. */
+
+bool compare_and_swap(bool &x, const bool &old_val, const bool &new_val);
+
+template <typename T>
+class pma {
+public:
+    static const int64_t leaf_bits = 5;
+    static const int64_t leaf_size = 1 << leaf_bits;
+
+    std::vector<NodeID> srcs;          // source of every slot
+    std::vector<T> nbs;                // neighbor of every slot
+    std::vector<int64_t> count;        // live entries of every leaf
+    std::vector<int64_t> vertex_start; // slot of a vertex's first edge, -1 if none
+    std::vector<int64_t> degree;
+    int64_t num_leaves = 1;
+    int64_t num_elems = 0;
+    int64_t num_rebalances = 0;
+    int64_t num_resizes = 0;
+
+    explicit pma(int64_t n);
+    void insert_batch(std::vector<std::pair<NodeID, T>> &edges);
+    int64_t capacity() const { return num_leaves << leaf_bits; }
+
+    // slot of the entry following the one in slot, capacity() at the end
+    int64_t next_slot(int64_t slot) const {
+        int64_t leaf = slot >> leaf_bits;
+        if (slot + 1 < (leaf << leaf_bits) + count[leaf])
+            return slot + 1;
+        return (leaf + 1) << leaf_bits;
+    }
+
+private:
+    typedef std::pair<NodeID, T> entry;
+
+    // new edges of a batch, grouped by the leaf they fall into
+    struct pending {
+        std::vector<entry> edges;
+        std::vector<int64_t> begin, end;
+        std::vector<char> overflow;
+    };
+
+    static constexpr float leaf_density = 1.0;
+    static constexpr float root_density = 0.75;
+
+    static bool key_less(NodeID s1, NodeID v1, NodeID s2, NodeID v2) {
+        return s1 != s2 ? s1 < s2 : v1 < v2;
+    }
+    bool slot_less(int64_t slot, NodeID u, NodeID v) const {
+        return key_less(srcs[slot], nbs[slot].getNodeID(), u, v);
+    }
+    int height() const;
+    float upper_density(int level) const;
+    int64_t find_leaf(NodeID u, NodeID v) const;
+    int64_t find(NodeID u, NodeID v) const;
+    void merge_into_leaf(int64_t leaf, const entry* first, const entry* last);
+    void collect(int64_t first_leaf, int64_t last_leaf, const pending &p, std::vector<entry> &out) const;
+    void spread(const std::vector<entry> &elems, int64_t first_leaf, int64_t last_leaf);
+    void redistribute(int64_t first_leaf, int64_t last_leaf, const pending &p);
+    void resize(int64_t new_leaves, const pending &p);
+    void fix_starts(const std::vector<char> &touched);
+};
+
+template <typename T>
+pma<T>::pma(int64_t n):
+    srcs(leaf_size, -1),
+    nbs(leaf_size),
+    count(1, 0),
+    vertex_start(n, -1),
+    degree(n, 0) {}
+
+template <typename T>
+int pma<T>::height() const
+{
+    int h = 0;
+    while ((int64_t(1) << h) < num_leaves)
+        h++;
+    return h;
+}
+
+template <typename T>
+float pma<T>::upper_density(int level) const
+{
+    int h = height();
+    if (h == 0)
+        return root_density;
+    return leaf_density - (leaf_density - root_density) * level / h;
+}
+
+// last leaf whose first key is <= (u, v), or leaf 0
+template <typename T>
+int64_t pma<T>::find_leaf(NodeID u, NodeID v) const
+{
+    int64_t lo = 0, hi = num_leaves - 1;
+    if (num_elems == 0)
+        return 0;
+    while (lo < hi) {
+        int64_t mid = (lo + hi + 1) / 2;
+        if (slot_less(mid << leaf_bits, u, v) ||
+            (srcs[mid << leaf_bits] == u && nbs[mid << leaf_bits].getNodeID() == v))
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+template <typename T>
+int64_t pma<T>::find(NodeID u, NodeID v) const
+{
+    if (num_elems == 0 || vertex_start[u] < 0)
+        return -1;
+    int64_t leaf = find_leaf(u, v);
+    int64_t lo = leaf << leaf_bits, hi = lo + count[leaf];
+    while (lo < hi) {
+        int64_t mid = (lo + hi) / 2;
+        if (slot_less(mid, u, v))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo < (leaf << leaf_bits) + count[leaf] &&
+        srcs[lo] == u && nbs[lo].getNodeID() == v)
+        return lo;
+    return -1;
+}
+
+// merge sorted [first, last) into a leaf that has room for all of it
+template <typename T>
+void pma<T>::merge_into_leaf(int64_t leaf, const entry* first, const entry* last)
+{
+    int64_t base = leaf << leaf_bits;
+    int64_t i = base + count[leaf] - 1;
+    int64_t out = base + count[leaf] + (last - first) - 1;
+    const entry* p = last - 1;
+    while (p >= first) {
+        if (i >= base && !slot_less(i, p->first, p->second.getNodeID())) {
+            srcs[out] = srcs[i];
+            nbs[out] = nbs[i];
+            i--;
+        } else {
+            srcs[out] = p->first;
+            nbs[out] = p->second;
+            p--;
+        }
+        out--;
+    }
+    count[leaf] += last - first;
+}
+
+// live entries of [first_leaf, last_leaf) merged with the leaves' overflow
+template <typename T>
+void pma<T>::collect(int64_t first_leaf, int64_t last_leaf, const pending &p, std::vector<entry> &out) const
+{
+    for (int64_t l = first_leaf; l < last_leaf; l++) {
+        int64_t i = l << leaf_bits, iend = i + count[l];
+        int64_t j = 0, jend = 0;
+        if (l < int64_t(p.overflow.size()) && p.overflow[l]) {
+            j = p.begin[l];
+            jend = p.end[l];
+        }
+        while (i < iend || j < jend) {
+            if (j == jend || (i < iend &&
+                slot_less(i, p.edges[j].first, p.edges[j].second.getNodeID()))) {
+                out.emplace_back(srcs[i], nbs[i]);
+                i++;
+            } else {
+                out.push_back(p.edges[j]);
+                j++;
+            }
+        }
+    }
+}
+
+// spread sorted elems evenly over [first_leaf, last_leaf)
+template <typename T>
+void pma<T>::spread(const std::vector<entry> &elems, int64_t first_leaf, int64_t last_leaf)
+{
+    int64_t leaves = last_leaf - first_leaf;
+    int64_t per_leaf = elems.size() / leaves, rem = elems.size() % leaves;
+    int64_t pos = 0;
+    for (int64_t k = 0; k < leaves; k++) {
+        int64_t l = first_leaf + k;
+        int64_t c = per_leaf + (k < rem ? 1 : 0);
+        for (int64_t i = 0; i < c; i++) {
+            srcs[(l << leaf_bits) + i] = elems[pos + i].first;
+            nbs[(l << leaf_bits) + i] = elems[pos + i].second;
+        }
+        count[l] = c;
+        pos += c;
+    }
+}
+
+template <typename T>
+void pma<T>::redistribute(int64_t first_leaf, int64_t last_leaf, const pending &p)
+{
+    std::vector<entry> elems;
+    elems.reserve((last_leaf - first_leaf) << leaf_bits);
+    collect(first_leaf, last_leaf, p, elems);
+    spread(elems, first_leaf, last_leaf);
+}
+
+template <typename T>
+void pma<T>::resize(int64_t new_leaves, const pending &p)
+{
+    std::vector<entry> elems;
+    collect(0, num_leaves, p, elems);
+    num_leaves = new_leaves;
+    srcs.assign(capacity(), -1);
+    nbs.assign(capacity(), T());
+    count.assign(num_leaves, 0);
+    spread(elems, 0, num_leaves);
+}
+
+/* Recompute vertex_start for the vertices that have entries in touched leaves.
+   Entries never leave the window they are redistributed in, so a start that
+   points outside every touched leaf is still valid. Starts that point into a
+   touched leaf are reset first and then lowered to the first slot found. */
+template <typename T>
+void pma<T>::fix_starts(const std::vector<char> &touched)
+{
+    const int64_t none = std::numeric_limits<int64_t>::max();
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int64_t l = 0; l < num_leaves; l++) {
+        if (!touched[l])
+            continue;
+        int64_t base = l << leaf_bits;
+        for (int64_t i = base; i < base + count[l]; i++) {
+            if (i > base && srcs[i] == srcs[i - 1])
+                continue;
+            int64_t s = vertex_start[srcs[i]];
+            if (s < 0 || (s != none && touched[s >> leaf_bits]))
+                vertex_start[srcs[i]] = none;
+        }
+    }
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int64_t l = 0; l < num_leaves; l++) {
+        if (!touched[l])
+            continue;
+        int64_t base = l << leaf_bits;
+        for (int64_t i = base; i < base + count[l]; i++) {
+            if (i > base && srcs[i] == srcs[i - 1])
+                continue;
+            int64_t *start = &vertex_start[srcs[i]];
+            int64_t old = *start;
+            while (i < old && !__sync_bool_compare_and_swap(start, old, i))
+                old = *start;
+        }
+    }
+}
+
+template <typename T>
+void pma<T>::insert_batch(std::vector<std::pair<NodeID, T>> &edges)
+{
+    auto by_key = [](const entry &a, const entry &b) {
+        return key_less(a.first, a.second.getNodeID(), b.first, b.second.getNodeID());
+    };
+    // stable, so the last copy of a duplicate edge is the latest one
+    std::stable_sort(edges.begin(), edges.end(), by_key);
+
+    // overwrite edges that exist already, keep the rest
+    std::vector<char> is_new(edges.size(), 0);
+    #pragma omp parallel for
+    for (int64_t i = 0; i < int64_t(edges.size()); i++) {
+        if (i + 1 < int64_t(edges.size()) && edges[i + 1].first == edges[i].first &&
+            edges[i + 1].second.getNodeID() == edges[i].second.getNodeID())
+            continue;
+        int64_t slot = find(edges[i].first, edges[i].second.getNodeID());
+        if (slot >= 0)
+            nbs[slot] = edges[i].second;
+        else
+            is_new[i] = 1;
+    }
+
+    pending p;
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (is_new[i]) {
+            p.edges.push_back(edges[i]);
+            degree[edges[i].first]++;
+        }
+    }
+    if (p.edges.empty())
+        return;
+
+    // new edges are sorted, so each leaf receives a contiguous run
+    std::vector<int64_t> leaf_of(p.edges.size());
+    #pragma omp parallel for
+    for (int64_t i = 0; i < int64_t(p.edges.size()); i++)
+        leaf_of[i] = find_leaf(p.edges[i].first, p.edges[i].second.getNodeID());
+    p.begin.assign(num_leaves, 0);
+    p.end.assign(num_leaves, 0);
+    p.overflow.assign(num_leaves, 0);
+    for (int64_t i = 0; i < int64_t(p.edges.size()); i++) {
+        if (i == 0 || leaf_of[i] != leaf_of[i - 1])
+            p.begin[leaf_of[i]] = i;
+        p.end[leaf_of[i]] = i + 1;
+    }
+
+    // leaves with room take their run directly
+    std::vector<char> touched(num_leaves, 0);
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int64_t l = 0; l < num_leaves; l++) {
+        int64_t n = p.end[l] - p.begin[l];
+        if (n == 0)
+            continue;
+        if (count[l] + n > leaf_size) {
+            p.overflow[l] = 1;
+            continue;
+        }
+        merge_into_leaf(l, p.edges.data() + p.begin[l], p.edges.data() + p.end[l]);
+        touched[l] = 1;
+    }
+
+    // the rest go to the smallest window under its density bound
+    std::vector<int64_t> demand(num_leaves + 1, 0);
+    for (int64_t l = 0; l < num_leaves; l++)
+        demand[l + 1] = demand[l] + count[l] + (p.overflow[l] ? p.end[l] - p.begin[l] : 0);
+    std::vector<std::pair<int64_t, int64_t>> windows;
+    bool grow = false;
+    int h = height();
+    for (int64_t l = 0; l < num_leaves && !grow; l++) {
+        if (!p.overflow[l] || (!windows.empty() && l < windows.back().second))
+            continue;
+        int level = 1;
+        int64_t first = 0, last = 0;
+        for (; level <= h; level++) {
+            int64_t size = int64_t(1) << level;
+            first = l & ~(size - 1);
+            last = first + size;
+            if (demand[last] - demand[first] <= upper_density(level) * (size << leaf_bits))
+                break;
+        }
+        if (level > h) {
+            grow = true;
+            break;
+        }
+        while (!windows.empty() && windows.back().first >= first)
+            windows.pop_back();
+        windows.emplace_back(first, last);
+    }
+
+    if (grow) {
+        int64_t new_leaves = num_leaves * 2;
+        while (demand[num_leaves] > root_density * (new_leaves << leaf_bits))
+            new_leaves *= 2;
+        resize(new_leaves, p);
+        touched.assign(num_leaves, 1);
+        num_resizes++;
+    } else {
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (size_t w = 0; w < windows.size(); w++) {
+            redistribute(windows[w].first, windows[w].second, p);
+            for (int64_t l = windows[w].first; l < windows[w].second; l++)
+                touched[l] = 1;
+        }
+        num_rebalances += windows.size();
+    }
+    num_elems += p.edges.size();
+    fix_starts(touched);
+}
+
+template <typename T>
+class pcsr: public dataStruc {
+    private:
+      int64_t num_nodes_initialize;
+      void processMetaData(const Edge& e, bool source);
+
+    public:
+      pma<T> out;
+      pma<T> in;    // only filled for directed graphs
+      pcsr(bool w, bool d, int64_t _num_nodes);
+      void update(const EdgeList& el) override;
+      void print() override;
+      int64_t in_degree(NodeID n) override;
+      int64_t out_degree(NodeID n) override;
+};
+
+template <typename T>
+pcsr<T>::pcsr(bool w, bool d, int64_t _num_nodes):
+    dataStruc(w, d),
+    num_nodes_initialize(_num_nodes),
+    out(_num_nodes),
+    in(d ? _num_nodes : 0)
+{
+    affected.resize(num_nodes_initialize);
+}
+
+template <typename T>
+void pcsr<T>::processMetaData(const Edge& e, bool source)
+{
+    bool exists = source ? e.sourceExists : e.destExists;
+    NodeID v = source ? e.source : e.destination;
+
+    affected.insert(v);
+
+    if (!exists)
+        stinger_int64_fetch_add(&num_nodes, 1);
+    stinger_int64_fetch_add(&num_edges, 1);
+}
+
+template <typename T>
+void pcsr<T>::update(const EdgeList& el)
+{
+    #pragma omp parallel for
+    for (unsigned int k = 0; k < el.size(); k++) {
+        processMetaData(el[k], true);
+        processMetaData(el[k], false);
+    }
+
+    std::vector<std::pair<NodeID, T>> out_edges, in_edges;
+    out_edges.reserve(directed ? el.size() : 2 * el.size());
+    if (directed)
+        in_edges.reserve(el.size());
+    for (const Edge &e : el) {
+        T nb;
+        nb.setInfo(e.destination, e.weight);
+        out_edges.emplace_back(e.source, nb);
+        nb.setInfo(e.source, e.weight);
+        if (directed)
+            in_edges.emplace_back(e.destination, nb);
+        else
+            out_edges.emplace_back(e.destination, nb);
+    }
+    out.insert_batch(out_edges);
+    if (directed)
+        in.insert_batch(in_edges);
+}
+
+template <typename T>
+int64_t pcsr<T>::in_degree(NodeID n)
+{
+    if (directed)
+        return in.degree[n];
+    else
+        return out.degree[n];
+}
+
+template <typename T>
+int64_t pcsr<T>::out_degree(NodeID n)
+{
+    return out.degree[n];
+}
+
+template <typename T>
+void pcsr<T>::print()
+{
+    std::cout << " numNodes: " << num_nodes <<
+            " numEdges: " << num_edges <<
+            " weighted: " << weighted <<
+            " directed: " << directed <<
+            " pmaSlots: " << out.capacity() <<
+            " pmaDensity: " << float(out.num_elems) / out.capacity() <<
+            " rebalances: " << out.num_rebalances <<
+            " resizes: " << out.num_resizes <<
+    std::endl;
+}
+
+#endif  // PCSR_H_
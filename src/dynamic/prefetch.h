@@ -0,0 +1,132 @@
+#ifndef PREFETCH_H_
+#define PREFETCH_H_
+
+#include <cstdint>
+
+#include "neighbor_block.h"
+
+/* Software prefetching for frontier loops.
+
+   Frontier vertices come in no particular order, so every one of them
+   starts with misses on its adjacency header, its neighbor IDs and the
+   property entries of those neighbors. Called at the top of each frontier
+   iteration, prefetch_frontier() pipelines those three loads over the
+   vertices ahead of the current one:
+
+     distance * 2 ahead   adjacency header (vector object, stinger vertex, CSR offsets)
+     distance ahead       first block of neighbor IDs
+     next vertex          property entries of its first kPrefetchNeighbors neighbors
+
+   The distance is set per data structure in prefetch_config; 0 turns
+   prefetching off for structures whose neighbor lists have no fixed
+   header to fetch (hashing, packed arrays, compressed or logged lists). */
+
+template <typename T>
+struct prefetch_config {
+    static const int64_t distance = 0;
+};
+
+template <typename U>
+struct prefetch_config<adList<U>> {
+    static const int64_t distance = 8;
+};
+
+template <typename U>
+struct prefetch_config<adListShared<U>> {
+    static const int64_t distance = 8;
+};
+
+template <typename U>
+struct prefetch_config<adListChunked<U>> {
+    static const int64_t distance = 8;
+};
+
+template <typename U>
+struct prefetch_config<csrDelta<U>> {
+    static const int64_t distance = 16;
+};
+
+template <typename U>
+struct prefetch_config<csrGraph<U>> {
+    static const int64_t distance = 16;
+};
+
+// reaching the IDs takes a dependent load of the edge block, so keep the
+// prefetched lines closer to their use
+template <>
+struct prefetch_config<stinger> {
+    static const int64_t distance = 4;
+};
+
+const int64_t kPrefetchNeighbors = 8;
+
+template <typename T>
+inline void prefetch_adjacency(T* ds, NodeID n, bool in_neigh)
+{
+    (void)ds; (void)n; (void)in_neigh;
+}
+
+template <typename U>
+inline void prefetch_adjacency(adList<U>* ds, NodeID n, bool in_neigh)
+{
+    __builtin_prefetch(in_neigh ? &ds->in_neighbors[n] : &ds->out_neighbors[n]);
+}
+
+template <typename U>
+inline void prefetch_adjacency(adListShared<U>* ds, NodeID n, bool in_neigh)
+{
+    __builtin_prefetch(in_neigh ? &ds->in_neighbors[n] : &ds->out_neighbors[n]);
+}
+
+template <typename U>
+inline void prefetch_adjacency(adListChunked<U>* ds, NodeID n, bool in_neigh)
+{
+    __builtin_prefetch(&ds->neighbors(n, in_neigh));
+}
+
+template <typename U>
+inline void prefetch_adjacency(csrDelta<U>* ds, NodeID n, bool in_neigh)
+{
+    csr_delta_store<U> &s = in_neigh ? ds->in : ds->out;
+    __builtin_prefetch(&s.base->offsets[n]);
+    __builtin_prefetch(&s.ranges[n]);
+}
+
+template <typename U>
+inline void prefetch_adjacency(csrGraph<U>* ds, NodeID n, bool in_neigh)
+{
+    __builtin_prefetch(&(in_neigh ? ds->in : ds->out).offsets[n]);
+}
+
+inline void prefetch_adjacency(stinger* ds, NodeID n, bool in_neigh)
+{
+    (void)in_neigh;
+    __builtin_prefetch(&ds->vertices[n]);
+}
+
+// it points at the current frontier entry; in_neigh tells whether the loop
+// walks in_neigh() or out_neigh(); prop is the property the loop reads per neighbor
+template <typename T, typename P>
+inline void prefetch_frontier(T* ds, const NodeID* it, const NodeID* end, bool in_neigh, const P* prop)
+{
+    const int64_t distance = prefetch_config<T>::distance;
+    if (distance == 0)
+        return;
+    bool in = in_neigh && ds->directed;
+    int64_t ahead = end - it;
+    if (ahead > 2 * distance)
+        prefetch_adjacency(ds, it[2 * distance], in);
+    if (ahead > distance) {
+        neighbor_block b = first_neighbor_block(ds, it[distance], in);
+        if (b.count > 0)
+            __builtin_prefetch(b.ids);
+    }
+    if (ahead > 1) {
+        neighbor_block b = first_neighbor_block(ds, it[1], in);
+        int64_t count = b.count < kPrefetchNeighbors ? b.count : kPrefetchNeighbors;
+        for (int64_t j = 0; j < count; j++)
+            __builtin_prefetch(prop + b.id(j));
+    }
+}
+
+#endif  // PREFETCH_H_
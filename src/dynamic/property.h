@@ -0,0 +1,86 @@
+#ifndef PROPERTY_H_
+#define PROPERTY_H_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "types.h"
+#include "../common/platform_atomics.h"
+
+/* Per-vertex algorithm results, typed per algorithm (depths, labels,
+   ranks, distances) instead of one shared float array. Every algorithm
+   grows its property to the current vertex count before running; new
+   vertices start at the initial value, which the incremental algorithms
+   use to detect them. */
+
+// component/max labels are vertex IDs
+typedef uint32_t Label;
+const Label kNoLabel = std::numeric_limits<Label>::max();
+
+template <typename P>
+class vertex_property {
+    std::vector<P> values;
+    P init;
+
+public:
+    explicit vertex_property(P _init): init(_init) {}
+
+    void resize(int64_t n) {
+        if (static_cast<int64_t>(values.size()) < n)
+            values.resize(n, init);
+    }
+
+    P& operator[](NodeID n) { return values[n]; }
+    const P& operator[](NodeID n) const { return values[n]; }
+    bool empty() const { return values.empty(); }
+    int64_t size() const { return values.size(); }
+};
+
+// lower x to v; returns true if this call changed x
+template <typename P>
+bool atomic_min(P &x, P v)
+{
+    P old = x;
+    while (v < old) {
+        if (compare_and_swap(x, old, v))
+            return true;
+        old = x;
+    }
+    return false;
+}
+
+// raise x to v; returns true if this call changed x
+template <typename P>
+bool atomic_max(P &x, P v)
+{
+    P old = x;
+    while (v > old) {
+        if (compare_and_swap(x, old, v))
+            return true;
+        old = x;
+    }
+    return false;
+}
+
+// add v to x; returns the value x held before
+template <typename P>
+P atomic_add(P &x, P v)
+{
+    P old = x;
+    while (!compare_and_swap(x, old, old + v))
+        old = x;
+    return old;
+}
+
+// set x to v; returns the value x held before
+template <typename P>
+P atomic_exchange(P &x, P v)
+{
+    P old = x;
+    while (!compare_and_swap(x, old, v))
+        old = x;
+    return old;
+}
+
+#endif  // PROPERTY_H_
@@ -25,30 +25,16 @@ public:
                 rhh_elem(k, v, 0) {}
         rhh_elem():
                 rhh_elem(K{}, V{}, 0) {}
-        inline void mark_deleted();
         inline bool empty() const;
-        inline bool deleted() const;
         std::string to_string();
 };
 
-template <typename K, typename V>
-void rhh_elem<K, V>::mark_deleted()
-{
-        hash |= 0x80000000;
-}
-
 template <typename K, typename V>
 bool rhh_elem<K, V>::empty() const
 {
         return hash == 0;
 }
 
-template <typename K, typename V>
-bool rhh_elem<K, V>::deleted() const
-{
-        return hash >> 31 == 1;
-}
-
 template <typename K, typename V>
 std::string rhh_elem<K, V>::to_string()
 {
@@ -71,7 +57,7 @@ public:
         rhh():
                 rhh(pow(2, 20)) {}
         rhh(rhh&) = delete;
-        void insert_elem(K key, V val);
+        bool insert_elem(K key, V val);
         bool delete_elem(K const &key);
         bool get_elem(K const &key, V &val) const;
         inline uint32_t get_capacity() const;
@@ -90,6 +76,7 @@ protected:
                 K const &k,
                 V const &v);
         bool find_elem(K const &key, uint32_t &i) const;
+        void backward_shift(uint32_t pos);
         void double_capacity();
         float load_factor;
         uint32_t size = 0;
@@ -137,7 +124,7 @@ void rhh<K, V>::do_insert(
 }
 
 template <typename K, typename V>
-void rhh<K, V>::insert_elem(K key, V val)
+bool rhh<K, V>::insert_elem(K key, V val)
 {
         if (size >= arr.capacity() * load_factor)
                 double_capacity();
@@ -148,20 +135,14 @@ void rhh<K, V>::insert_elem(K key, V val)
         for (;;) {
                 if (arr[pos].empty()) {
                         do_insert(pos, h, key, val);
-                        return;
+                        return true;
                 }
                 if (arr[pos].key == key) {
                         arr[pos].val = val;
-                        if (arr[pos].deleted())
-                                arr[pos].hash = h;
-                        return;
+                        return false;
                 }
                 existing = probe_dist(desired_pos(arr[pos].hash), pos);
                 if (probe_dist(origin, pos) > existing) {
-                        if (arr[pos].deleted()) {
-                                do_insert(pos, h, key, val);
-                                return;
-                        }
                         std::swap(key, arr[pos].key);
                         std::swap(val, arr[pos].val);
                         std::swap(h, arr[pos].hash);
@@ -170,18 +151,35 @@ void rhh<K, V>::insert_elem(K key, V val)
         }
 }
 
+/* Backward-shift deletion: pull the following cluster one slot back so no
+   tombstone is left behind and probe sequences stay as short as if the key
+   had never been inserted. Positions of other elements may change, so this
+   must not be called while an iterator over the table is live. */
 template <typename K, typename V>
 bool rhh<K, V>::delete_elem(K const &key)
 {
         uint32_t i;
         bool found = find_elem(key, i);
         if (found) {
-                arr[i].mark_deleted();
+                backward_shift(i);
                 --size;
         }
         return found;
 }
 
+template <typename K, typename V>
+void rhh<K, V>::backward_shift(uint32_t pos)
+{
+        uint32_t next = (pos + 1) % arr.capacity();
+        while (!arr[next].empty() &&
+               probe_dist(desired_pos(arr[next].hash), next) > 0) {
+                arr[pos] = arr[next];
+                pos = next;
+                next = (pos + 1) % arr.capacity();
+        }
+        arr[pos] = rhh_elem<K, V>();
+}
+
 template <typename K, typename V>
 bool rhh<K, V>::get_elem(K const &key, V &val) const
 {
@@ -221,7 +219,7 @@ bool rhh<K, V>::find_elem(K const &key, uint32_t &pos) const
                 pos = (origin + d) % arr.capacity();
                 if (arr[pos].empty())
                         break;
-                else if (arr[pos].key == key && !arr[pos].deleted())
+                else if (arr[pos].key == key)
                         return true;
                 else if (d > probe_dist(desired_pos(arr[pos].hash), pos))
                         break;
@@ -232,13 +230,13 @@ bool rhh<K, V>::find_elem(K const &key, uint32_t &pos) const
 template <typename K, typename V>
 void rhh<K, V>::double_capacity()
 {
-        std::vector<rhh_elem<K, V>> old_arr(arr);
+        std::vector<rhh_elem<K, V>> old_arr(std::move(arr));
         arr = std::vector<rhh_elem<K, V>>(
                 old_arr.capacity() * 2,
                 rhh_elem<K, V>());
         size = 0;
         for (uint32_t i = 0; i < old_arr.capacity(); ++i) {
-                if (!old_arr[i].empty() && !old_arr[i].deleted())
+                if (!old_arr[i].empty())
                         insert_elem(old_arr[i].key, old_arr[i].val);
         }
         return;
@@ -250,7 +248,7 @@ int32_t rhh<K, V>::avg_probe_dist() const
         long long sum = 0;
         for(int pos = 0; pos < arr.capacity(); ++pos)
         {
-                if (!arr[pos].empty() && !arr[pos].deleted())
+                if (!arr[pos].empty())
                         sum += probe_dist(desired_pos(arr[pos].hash), pos);
         }
         return static_cast<int32_t>(sum / arr.capacity());
@@ -0,0 +1,86 @@
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include "traversal.h"
+#include "csrGraph.h"
+
+/* Materializes a csrGraph snapshot of a live data structure. Offsets come
+   from the dense degree arrays, so every neighbor list is copied straight
+   into place, one vertex per iteration and in parallel. */
+
+template <typename U, typename T>
+void fillCSR(T* ds, bool in, const int64_t* degree, csr_snapshot<U>& csr)
+{
+    int64_t n = ds->num_nodes;
+    csr.offsets.resize(n + 1);
+    csr.offsets[0] = 0;
+    for (NodeID u = 0; u < n; u++)
+        csr.offsets[u + 1] = csr.offsets[u] + degree[u];
+    csr.neighbors.resize(csr.offsets[n]);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (NodeID u = 0; u < n; u++) {
+        U* out = csr.neighbors.data() + csr.offsets[u];
+        neighborhood<T> neigh(u, ds, in);
+        for (neighborhood_iter<T> it = neigh.begin(); it != neigh.end(); it++)
+            (out++)->setInfo(*it, it.extractWeight());
+    }
+}
+
+// call after ds->update() and ds->sync_degrees()
+template <typename U, typename T>
+void buildSnapshot(T* ds, csrGraph<U>* snap)
+{
+    degree_view deg = ds->degrees();
+    snap->num_nodes = ds->num_nodes;
+    snap->num_edges = ds->num_edges;
+    fillCSR(ds, false, deg.out, snap->out);
+    snap->out_degrees.assign(deg.out, deg.out + ds->num_nodes);
+    if (ds->directed) {
+        fillCSR(ds, true, deg.in, snap->in);
+        snap->in_degrees.assign(deg.in, deg.in + ds->num_nodes);
+    }
+}
+
+template <typename U>
+void snapshotAs(dataStruc* ds, csrGraph<U>* snap)
+{
+    if (adListShared<U>* g = dynamic_cast<adListShared<U>*>(ds))
+        buildSnapshot(g, snap);
+    else if (adListChunked<U>* g = dynamic_cast<adListChunked<U>*>(ds))
+        buildSnapshot(g, snap);
+    else if (darhh<U>* g = dynamic_cast<darhh<U>*>(ds))
+        buildSnapshot(g, snap);
+    else if (adList<U>* g = dynamic_cast<adList<U>*>(ds))
+        buildSnapshot(g, snap);
+    else if (csrDelta<U>* g = dynamic_cast<csrDelta<U>*>(ds))
+        buildSnapshot(g, snap);
+    else if (pcsr<U>* g = dynamic_cast<pcsr<U>*>(ds))
+        buildSnapshot(g, snap);
+    else if (edgeLog<U>* g = dynamic_cast<edgeLog<U>*>(ds))
+        buildSnapshot(g, snap);
+    else if (stinger* g = dynamic_cast<stinger*>(ds))
+        buildSnapshot(g, snap);
+    else if (adListCompressed* g = dynamic_cast<adListCompressed*>(ds))
+        buildSnapshot(g, snap);
+}
+
+// empty snapshot with the entry type of ds
+inline dataStruc* createSnapshot(const dataStruc* ds)
+{
+    if (ds->weighted)
+        return new csrGraph<NodeWeight>(true, ds->directed);
+    else
+        return new csrGraph<Node>(false, ds->directed);
+}
+
+// rebuilds snap, made by createSnapshot(ds), from the current ds
+inline void snapshotGraph(dataStruc* ds, dataStruc* snap)
+{
+    if (csrGraph<NodeWeight>* s = dynamic_cast<csrGraph<NodeWeight>*>(snap))
+        snapshotAs(ds, s);
+    else if (csrGraph<Node>* s = dynamic_cast<csrGraph<Node>*>(snap))
+        snapshotAs(ds, s);
+}
+
+#endif  // SNAPSHOT_H_
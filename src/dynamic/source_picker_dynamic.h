@@ -29,7 +29,7 @@ class DynamicSourcePicker {
     do {
       num_trials++;
       source = udist(rng);      
-    } while ((ds->out_degree(source) == 0) && (num_trials < ds->num_nodes));
+    } while ((ds->degrees().out_degree(source) == 0) && (num_trials < ds->num_nodes));
     
     if(num_trials == ds->num_nodes) source = -1;
     return source;
@@ -1,24 +1,77 @@
 #include "stinger.h"
 
+#include <new>
+#include <omp.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 bool compare_and_swap(bool &x, const bool &old_val, const bool &new_val){
     return __sync_bool_compare_and_swap(&x, old_val, new_val);
 }
 
-stinger::stinger(bool w, bool d, int64_t _num_nodes):
-dataStruc(w,d){        
+stinger_eb_pool::stinger_eb_pool(int64_t _edges_per_block):
+edges_per_block(_edges_per_block),
+block_bytes(sizeof(stinger_eb) + _edges_per_block * (sizeof(NodeID) + sizeof(Weight) + sizeof(int64_t))),
+locals(omp_get_max_threads()),
+num_blocks(0){}
+
+stinger_eb_pool::~stinger_eb_pool(){
+    for(char* slab: slabs) delete[] slab;
+}
+
+char* stinger_eb_pool::new_slab(){
+    char* slab = new char[block_bytes * BLOCKS_PER_SLAB];
+    std::lock_guard<std::mutex> guard(slabs_mutex);
+    slabs.push_back(slab);
+    return slab;
+}
+
+stinger_eb* stinger_eb_pool::alloc(NodeID n){
+    char* mem;
+    size_t tid = omp_get_thread_num();
+    if(tid < locals.size()){
+        local_slab& local = locals[tid];
+        if(local.cur == local.end){
+            local.cur = new_slab();
+            local.end = local.cur + block_bytes * BLOCKS_PER_SLAB;
+        }
+        mem = local.cur;
+        local.cur += block_bytes;
+    }
+    else{
+        // more threads than we sized for, fall back to a block of its own 
+        mem = new char[block_bytes];
+        std::lock_guard<std::mutex> guard(slabs_mutex);
+        slabs.push_back(mem);
+    }
+    stinger_int64_fetch_add(&num_blocks, 1);
+
+    NodeID* neighbors = reinterpret_cast<NodeID*>(mem + sizeof(stinger_eb));
+    Weight* weights = reinterpret_cast<Weight*>(neighbors + edges_per_block);
+    int64_t* locks = reinterpret_cast<int64_t*>(weights + edges_per_block);
+    for(int64_t k = 0; k < edges_per_block; k++){
+        neighbors[k] = -1;
+        weights[k] = -1;
+        locks[k] = 0;
+    }
+    return new (mem) stinger_eb(n, neighbors, weights, locks);
+}
+
+stinger::stinger(bool w, bool d, int64_t _num_nodes, int64_t _edges_per_block):
+dataStruc(w,d), edges_per_block(_edges_per_block), pool(_edges_per_block){        
     //cout << "Created Stinger" << endl;
     num_nodes_initialize = _num_nodes;
 
-    // initialize 1) property 2) affected 3) vertices vectors 
-    property.resize(num_nodes_initialize, -1);
-    affected.resize(num_nodes_initialize); affected.fill(false);
+    // initialize 1) affected 2) vertices vectors 
+    affected.resize(num_nodes_initialize);
     
-    // we also create the first edgeblock for in-neighbor and out-neighbor 
+    for(int i=0; i<NUM_LOCK_SITES; i++) fe_lock_stats_reset(&lock_stats[i]);
+
+    // edge blocks are allocated lazily on a vertex's first edge 
+    vertices.reserve(num_nodes_initialize);
     for(NodeID i=0; i<num_nodes_initialize; i++){
-        stinger_vertex v(i);                
-        v.out_neighbors = new stinger_eb(i);
-        if(directed) v.in_neighbors = new stinger_eb(i);
-        vertices.push_back(v); 
+        vertices.push_back(stinger_vertex(i)); 
     }
 }
 
@@ -31,16 +84,14 @@ void stinger::out_degree_increment_atomic(NodeID n, int64_t degree){
 }
 
 // NodeID n = it is the neighbor ID 
-void stinger::update_edge_data(stinger_eb* eb, int index, NodeID n, Weight w, bool in_neighbor){
-    stinger_edge* e = eb->edges + index;
-    
-    Weight weight = readfe(&(e->weight)); //acquire lock on weight
+void stinger::update_edge_data(stinger_eb* eb, int64_t index, NodeID n, Weight w, bool in_neighbor){
+    Weight weight = readfe_stats(&(eb->weights[index]), &lock_stats[LOCK_EDGE_WEIGHT]); //acquire lock on weight
     weight = w;
 
     // if this is new edge     
-    if((e->neighbor < 0) || (index >= eb->high)){
+    if((eb->neighbors[index] < 0) || (index >= eb->high)){
         // register edge         
-        e->neighbor = n;
+        eb->neighbors[index] = n;
         stinger_int64_fetch_add(&eb->numEdges, 1);
 
         if(in_neighbor) in_degree_increment_atomic(eb->node, 1);
@@ -49,7 +100,7 @@ void stinger::update_edge_data(stinger_eb* eb, int index, NodeID n, Weight w, bo
         if(index >= eb->high) 
              eb->high = index + 1;
     }
-    writeef(&(e->weight), weight); // unlock weight 
+    writeef_stats(&(eb->weights[index]), weight, &lock_stats[LOCK_EDGE_WEIGHT]); // unlock weight 
 }
 
 void stinger::processMetaData(const Edge& e, bool source)
@@ -58,21 +109,7 @@ void stinger::processMetaData(const Edge& e, bool source)
     if(source) exists = e.sourceExists;
     else exists = e.destExists;
 
-    // using CAS operations implemented in GAP 
-    if(source){
-        NodeID v = e.source;
-        bool aff = affected[v];
-        if(!aff){
-            compare_and_swap(affected[v], aff, true);
-        }
-    }
-    else{
-        NodeID v = e.destination;
-        bool aff = affected[v];
-        if(!aff){
-            compare_and_swap(affected[v], aff, true);
-        }
-    }
+    affected.insert(source ? e.source : e.destination);
     
     if(exists){       
         stinger_int64_fetch_add(&num_edges, 1);                 
@@ -84,40 +121,85 @@ void stinger::processMetaData(const Edge& e, bool source)
     }  
 }
 
-void stinger::search_and_insert_edge(const Edge& e, bool source, stinger_eb* eb, bool in_neighbor)
+/* Index of the first slot in [from, to) whose neighbor is a or b, or to if
+   there is none. Compares a whole vector of neighbor IDs per step with the
+   widest instruction set the build targets; x86-64 always has SSE2. */
+static inline int64_t find_neighbor(const NodeID* nbrs, int64_t from, int64_t to, NodeID a, NodeID b)
+{
+    int64_t k = from;
+#if defined(__AVX512F__)
+    const __m512i va = _mm512_set1_epi64(a);
+    const __m512i vb = _mm512_set1_epi64(b);
+    for(; k + 8 <= to; k += 8){
+        __m512i v = _mm512_loadu_si512((const void*)(nbrs + k));
+        __mmask8 m = _mm512_cmpeq_epi64_mask(v, va) | _mm512_cmpeq_epi64_mask(v, vb);
+        if(m) return k + __builtin_ctz(m);
+    }
+#elif defined(__AVX2__)
+    const __m256i va = _mm256_set1_epi64x(a);
+    const __m256i vb = _mm256_set1_epi64x(b);
+    for(; k + 4 <= to; k += 4){
+        __m256i v = _mm256_loadu_si256((const __m256i*)(nbrs + k));
+        __m256i eq = _mm256_or_si256(_mm256_cmpeq_epi64(v, va), _mm256_cmpeq_epi64(v, vb));
+        int m = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        if(m) return k + __builtin_ctz(m);
+    }
+#elif defined(__SSE2__)
+    // no 64-bit compare before SSE4.1: both 32-bit halves have to match
+    const __m128i va = _mm_set1_epi64x(a);
+    const __m128i vb = _mm_set1_epi64x(b);
+    for(; k + 2 <= to; k += 2){
+        __m128i v = _mm_loadu_si128((const __m128i*)(nbrs + k));
+        __m128i ea = _mm_cmpeq_epi32(v, va);
+        __m128i eb = _mm_cmpeq_epi32(v, vb);
+        ea = _mm_and_si128(ea, _mm_shuffle_epi32(ea, _MM_SHUFFLE(2,3,0,1)));
+        eb = _mm_and_si128(eb, _mm_shuffle_epi32(eb, _MM_SHUFFLE(2,3,0,1)));
+        int m = _mm_movemask_pd(_mm_castsi128_pd(_mm_or_si128(ea, eb)));
+        if(m) return k + __builtin_ctz(m);
+    }
+#endif
+    for(; k < to; k++){
+        if(nbrs[k] == a || nbrs[k] == b) return k;
+    }
+    return to;
+}
+
+void stinger::search_and_insert_edge(const Edge& e, bool source, stinger_eb** head, bool in_neighbor)
 {
-    //make stinger edge 
-    stinger_edge edge(e, source);
-    NodeID dest = edge.neighbor;
-    Weight weight = edge.weight;    
+    NodeID dest = source? e.destination : e.source;
+    Weight weight = e.weight;    
 
     // check if edge already exists    
-    for(stinger_eb* tmp = eb; tmp != nullptr; tmp = (stinger_eb*)readff((int64_t *)&tmp->next)){
-        int64_t k, endk;
-        endk = tmp->high; 
-        for(k=0; k < endk; k++){            
-            if (dest == (tmp->edges[k].neighbor)){
-                // found edge; update weight 
-                update_edge_data(tmp, k, dest, weight, in_neighbor);
-                return;
-            }
+    fe_lock_stats* list_stats = &lock_stats[LOCK_BLOCK_LIST];
+    for(stinger_eb* tmp = (stinger_eb*)readff_stats((int64_t *)head, list_stats); tmp != nullptr; tmp = (stinger_eb*)readff_stats((int64_t *)&tmp->next, list_stats)){
+        int64_t endk = tmp->high; 
+        int64_t k = find_neighbor(tmp->neighbors, 0, endk, dest, dest);
+        if(k < endk){
+            // found edge; update weight 
+            update_edge_data(tmp, k, dest, weight, in_neighbor);
+            return;
         }
     }
 
-    stinger_eb** cur_loc = &eb; // pointer to pointer to manipulate stinger_ebs
+    stinger_eb** cur_loc = head; // pointer to pointer to manipulate stinger_ebs
     stinger_eb* tmp; // variable in for loop
     stinger_eb* cur_eb; // reset which eb to start from in each search pass 
 
     // Did not find edge; second pass 
     while(1){        
-        cur_eb = (stinger_eb*)readff((int64_t *)cur_loc);
+        cur_eb = (stinger_eb*)readff_stats((int64_t *)cur_loc, list_stats);
 
-        for(tmp = cur_eb; tmp != nullptr; tmp = (stinger_eb*)readff((int64_t *)&tmp->next)){
+        for(tmp = cur_eb; tmp != nullptr; tmp = (stinger_eb*)readff_stats((int64_t *)&tmp->next, list_stats)){
             int64_t k, endk;
             endk = tmp->high;
 
-            for(k=0; k < NUM_EDGES_PER_BLOCK; k++){
-                NodeID myNeighbor = (tmp->edges[k].neighbor);
+            for(k=0; k < edges_per_block; k++){
+                // skip over occupied slots that do not hold dest 
+                if(k < endk){
+                    k = find_neighbor(tmp->neighbors, k, endk, dest, -1);
+                    if(k >= edges_per_block) break;
+                }
+                NodeID myNeighbor = (tmp->neighbors[k]);
 
                 if ((dest == myNeighbor) && (k < endk)){
                     // found edge; update weight 
@@ -127,27 +209,27 @@ void stinger::search_and_insert_edge(const Edge& e, bool source, stinger_eb* eb,
 
                 if(myNeighbor < 0 || k >= endk){
                     // Found an empty slot for the edge, lock it and check again to make sure                    
-                    int64_t timefirst = readfe(&(tmp->edges[k].timeFirst));
-                    NodeID thisEdge = (tmp->edges[k].neighbor);
+                    int64_t timefirst = readfe_stats(&(tmp->locks[k]), &lock_stats[LOCK_EDGE_SLOT]);
+                    NodeID thisEdge = (tmp->neighbors[k]);
                     endk = tmp->high;
 
                     if (thisEdge < 0 || k >= endk) {
                         // Slot is empty, add the edge
                         update_edge_data(tmp, k, dest, weight, in_neighbor);
-                        writexf(&(tmp->edges[k].timeFirst), timefirst);
+                        writexf(&(tmp->locks[k]), timefirst);
                         return;
                     } 
                     
                     else if (dest == thisEdge) {
                         // Another thread just added the edge. Do a normal update                        
                         update_edge_data(tmp, k, dest, weight, in_neighbor);        
-                        writexf(&(tmp->edges[k].timeFirst), timefirst);               
+                        writexf(&(tmp->locks[k]), timefirst);               
                         return;
                     } 
                     
                     else {
                         // Another thread claimed the slot for a different edge, unlock and keep looking
-                        writexf(&(tmp->edges[k].timeFirst), timefirst); 
+                        writexf(&(tmp->locks[k]), timefirst); 
                     }
                 }
             }
@@ -156,24 +238,24 @@ void stinger::search_and_insert_edge(const Edge& e, bool source, stinger_eb* eb,
 
         /* 3: Needs a new block to be inserted at end of list. */
         // Try to lock the tail pointer of the last block        
-        stinger_eb* old_eb = (stinger_eb*)readfe((int64_t*)cur_loc);
+        stinger_eb* old_eb = (stinger_eb*)readfe_stats((int64_t*)cur_loc, list_stats);
         if (!old_eb){
             // create new edge block 
             NodeID s;
             if(source) s = e.source; 
             else s = e.destination;
 
-            stinger_eb* newBlock = new stinger_eb(s);
+            stinger_eb* newBlock = pool.alloc(s);
             
             // Add edge to the first slot in the new edge block 
             update_edge_data(newBlock, 0, dest, weight, in_neighbor);
                         
-            writeef((int64_t*)cur_loc, *((int64_t*)&newBlock));
+            writeef_stats((int64_t*)cur_loc, *((int64_t*)&newBlock), list_stats);
             return;
         }
         else{
             // Another thread already added a block, unlock and keep searching
-            writeef((int64_t*)cur_loc, *((int64_t*)&old_eb));
+            writeef_stats((int64_t*)cur_loc, *((int64_t*)&old_eb), list_stats);
         }
     }    
 }
@@ -185,12 +267,10 @@ void stinger::updateForVertex(const Edge& e, bool source){
     stinger_vertex* node = &vertices[n];
 
     if(source || (!source && !directed)){     
-        assert(node->out_neighbors != nullptr);   
-        search_and_insert_edge(e, source, node->out_neighbors, false);             
+        search_and_insert_edge(e, source, &node->out_neighbors, false);             
     }
     else if(!source && directed){ 
-        assert(node->in_neighbors != nullptr);        
-        search_and_insert_edge(e, source, node->in_neighbors, true);             
+        search_and_insert_edge(e, source, &node->in_neighbors, true);             
     } 
 }
 
@@ -228,14 +308,25 @@ void stinger::print_eb(stinger_eb* eb)
     cout << "  EDGES: " << endl;
 
     if(!(eb->numEdges == 0)){
-        for (uint64_t j = 0; j < NUM_EDGES_PER_BLOCK; j++){
-            cout << "   TO: " << eb->edges[j].neighbor << "   WGT: " << eb->edges[j].weight << 
-                    "   TFIRST:  " << eb->edges[j].timeFirst << endl;           
+        for (int64_t j = 0; j < edges_per_block; j++){
+            cout << "   TO: " << eb->neighbors[j] << "   WGT: " << eb->weights[j] << 
+                    "   LOCK:  " << eb->locks[j] << endl;           
         }
     }
     cout << endl;
 }
 
+void stinger::print_lock_stats()
+{
+    static const char* site_names[NUM_LOCK_SITES] = {"edgeWeight", "edgeSlot", "blockList"};
+    cout << " Lock contention (contended/spins/yields):";
+    for(int i=0; i<NUM_LOCK_SITES; i++){
+        cout << " " << site_names[i] << ": " << lock_stats[i].contended << 
+                "/" << lock_stats[i].spins << "/" << lock_stats[i].yields;
+    }
+    cout << endl;
+}
+
 void stinger::print()
 {
     cout << " Actual numNodes: " << num_nodes << 
@@ -243,7 +334,11 @@ void stinger::print()
             " numEdges: " << num_edges << 
             " weighted: " << weighted << 
             " directed: " << directed << 
+            " edgesPerBlock: " << edges_per_block << 
+            " edgeBlocks: " << pool.allocated_blocks() << 
+            " edgeBlockBytes: " << pool.allocated_bytes() << 
     endl;
+    print_lock_stats();
 
     /*for(unsigned int i=0; i < num_nodes; i++){
         cout << "####################################################################" << endl;
@@ -279,21 +374,7 @@ void stinger::print()
     if(source) exists = e.sourceExists;
     else exists = e.destExists;
 
-    // using CAS operations implemented in GAP 
-    if(source){
-        NodeID v = e.source;
-        bool aff = affected[v];
-        if(!aff){
-            compare_and_swap(affected[v], aff, true);
-        }
-    }
-    else{
-        NodeID v = e.destination;
-        bool aff = affected[v];
-        if(!aff){
-            compare_and_swap(affected[v], aff, true);
-        }
-    }
+    affected.insert(source ? e.source : e.destination);
     
     if(exists){       
         stinger_int64_fetch_add(&num_edges, 1);         
@@ -5,39 +5,67 @@
 #include "x86_full_empty.h"
 #include "print.h"
 #include <cassert>
+#include <mutex>
 
 using namespace std;
 
-const int64_t NUM_EDGES_PER_BLOCK = 16; 
+const int64_t NUM_EDGES_PER_BLOCK = 16; /**< Default edges per block, tunable with -e */
 
 bool compare_and_swap(bool &x, const bool &old_val, const bool &new_val);
 
-struct stinger_edge{
-    NodeID neighbor;
-    Weight weight;
-    int64_t timeFirst; /**< Random placeholder for locking empty space */
-
-    stinger_edge():neighbor(-1), weight(-1), timeFirst(0){}
-
-    stinger_edge(const Edge& e, bool source)
-    :timeFirst(0)
-    {
-        if(source) neighbor = e.destination;
-        else neighbor = e.source;
-        weight = e.weight;
-    }
-};
-
+/* Edge blocks use a struct-of-arrays layout: the neighbor IDs, weights and
+   slot lock words each live in their own array right after the header. Scans
+   over neighbors (duplicate search, unweighted traversal) only touch the
+   neighbor array, and it is dense enough to be compared with SIMD. */
 struct stinger_eb
 {
     NodeID node;            /**< Source vertex ID associated with this edgeblock*/
     int64_t numEdges;	    /**< Number of valid edges in the block */         
     int64_t high;           /**< High water mark */
     stinger_eb* next;	    /**< Pointer to the next edge block */       
-    stinger_edge edges[NUM_EDGES_PER_BLOCK]; /**< Array of edges, Node or NodeWeight*/    
+    NodeID* neighbors;      /**< Neighbor IDs, -1 marks an empty slot */
+    Weight* weights;        /**< Edge weights, the full/empty bit guards the weight update */
+    int64_t* locks;         /**< Per-slot lock words used to claim empty slots */
     
-    stinger_eb(NodeID n)
-    :node(n), numEdges(0), high(-1), next(nullptr){}
+    stinger_eb(NodeID n, NodeID* nbrs, Weight* w, int64_t* l)
+    :node(n), numEdges(0), high(-1), next(nullptr), neighbors(nbrs), weights(w), locks(l){}
+};
+
+/* Slab allocator for edge blocks. Every OpenMP thread carves blocks out of its
+   own slab, so inserting an overflow block never goes through the global heap.
+   Stinger never frees single blocks; all slabs are released with the pool. */
+class stinger_eb_pool{
+    private:
+      struct local_slab{
+          char* cur;
+          char* end;
+          char pad[64 - 2*sizeof(char*)]; /**< keep each thread on its own cache line */
+          local_slab():cur(nullptr), end(nullptr){}
+      };
+      static const int64_t BLOCKS_PER_SLAB = 256;
+      const int64_t edges_per_block;
+      const size_t block_bytes;
+      vector<local_slab> locals;      /**< indexed by omp_get_thread_num() */
+      vector<char*> slabs;
+      std::mutex slabs_mutex;
+      int64_t num_blocks;
+      char* new_slab();
+
+    public:
+      stinger_eb_pool(int64_t _edges_per_block);
+      ~stinger_eb_pool();
+      stinger_eb_pool(const stinger_eb_pool&) = delete;
+      stinger_eb* alloc(NodeID n);
+      int64_t allocated_blocks() const { return num_blocks; }
+      size_t allocated_bytes() const { return num_blocks * block_bytes; }
+};
+
+/* Full/empty-bit lock sites whose contention is counted separately */
+enum stinger_lock_site{
+    LOCK_EDGE_WEIGHT,       /**< weight word of an edge, held while the edge is updated */
+    LOCK_EDGE_SLOT,         /**< slot lock word, held while an empty slot is claimed */
+    LOCK_BLOCK_LIST,        /**< head/next pointers, held while a new edge block is linked */
+    NUM_LOCK_SITES
 };
 
 struct stinger_vertex
@@ -45,8 +73,8 @@ struct stinger_vertex
     NodeID node;
     int64_t in_degree;
     int64_t out_degree;
-    stinger_eb* in_neighbors;	  /**< Pointer to the first edge block in in_neighbors */
-    stinger_eb* out_neighbors;  /**< Pointer to the first edge block in out_neighbors */
+    stinger_eb* in_neighbors;	  /**< Pointer to the first edge block in in_neighbors, nullptr until the first edge */
+    stinger_eb* out_neighbors;  /**< Pointer to the first edge block in out_neighbors, nullptr until the first edge */
 
     stinger_vertex(NodeID _n)
     :node(_n),
@@ -59,6 +87,9 @@ struct stinger_vertex
 class stinger: public dataStruc{
     private:                     
       int64_t num_nodes_initialize;    /**< # of nodes we initialize with, not actual # of nodes */
+      int64_t edges_per_block;         /**< # of edge slots in every edge block */
+      stinger_eb_pool pool;
+      fe_lock_stats lock_stats[NUM_LOCK_SITES];
       //bool vertexExists(const Edge& e, bool source);
       //void updateForNewVertex(const Edge& e, bool source);
       //void updateForExistingVertex(const Edge& e, bool source); 
@@ -74,15 +105,16 @@ class stinger: public dataStruc{
       void updateForVertex(const Edge& e, bool source); 
 
       void print_eb(stinger_eb* eb);
+      void print_lock_stats();
       void in_degree_increment_atomic(NodeID n, int64_t degree);
       void out_degree_increment_atomic(NodeID n, int64_t degree);        
      
-      void update_edge_data(stinger_eb* eb, int index, NodeID n, Weight w, bool in_neighbor);    
-      void search_and_insert_edge(const Edge& e, bool source, stinger_eb* eb, bool in_neighbor); 
+      void update_edge_data(stinger_eb* eb, int64_t index, NodeID n, Weight w, bool in_neighbor);    
+      void search_and_insert_edge(const Edge& e, bool source, stinger_eb** head, bool in_neighbor); 
      
     public:          
       vector<stinger_vertex> vertices; // array of stinger_vertex  
-      stinger(bool w, bool d, int64_t _num_nodes);    
+      stinger(bool w, bool d, int64_t _num_nodes, int64_t _edges_per_block = NUM_EDGES_PER_BLOCK);    
       void update(const EdgeList& el) override;
       void print() override;
       int64_t in_degree(NodeID n) override;
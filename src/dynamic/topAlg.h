@@ -5,8 +5,10 @@
 This is the top API for performing an algorithm
 */
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "dyn_traverse.h"
 #include "dyn_pr.h"
@@ -15,6 +17,10 @@ This is the top API for performing an algorithm
 #include "dyn_bfs.h"
 #include "dyn_sssp.h"
 #include "dyn_sswp.h"
+#include "dyn_msbfs.h"
+#include "dyn_prpush.h"
+#include "dyn_ppr.h"
+#include "snapshot.h"
 #include "source_picker_dynamic.h"
 
 class dataStruc;
@@ -26,11 +32,47 @@ private:
     dataStruc* ds;    
     NodeID source;
     int batch;
+    algo_workspace ws;  // reused by the incremental algorithms across batches
+    // typed per-vertex results; only the running algorithm's one is filled
+    vertex_property<Rank> ranks;
+    vertex_property<Component> components;
+    vertex_property<Label> labels;
+    vertex_property<Depth> depths;
+    vertex_property<Distance> distances;
+    vertex_property<Width> widths;
+    vertex_property<LandmarkMask> reach;
+    vertex_property<LandmarkHops> hops;
+    std::vector<NodeID> landmarks;  // MS-BFS sources, picked once like source
+    pr_push_state pr_push;  // residual-push PR estimates, scaled by the vertex count
+    walk_store ppr_walks;   // Monte Carlo PPR random walks
+    dataStruc* snapshot;    // CSR copy of ds for the from-scratch algorithms, if any
 	bool is_adListST; // single thread adList
     bool is_adList;   // shared style multithreading
     bool is_stinger;  
     bool is_rhh; 
 	bool is_adList2;   // chunk style multithreading
+	bool is_csrDelta;  // CSR base + delta log
+	bool is_pcsr;      // packed memory array
+	bool is_compressed; // delta/varint encoded adjacency blocks
+	bool is_edgeLog;   // append-only edge log + archived adjacency
+
+    // picks up to kMaxLandmarks distinct sources on the first call
+    bool pickLandmarks() {
+		if (landmarks.empty()) {
+			DynamicSourcePicker sp(ds);
+			for (int trial = 0; trial < 4 * kMaxLandmarks; trial++) {
+				NodeID s = sp.PickNext();
+				if (s == -1)
+					break;
+				if (std::find(landmarks.begin(), landmarks.end(), s) == landmarks.end())
+					landmarks.push_back(s);
+				if (static_cast<int>(landmarks.size()) == kMaxLandmarks)
+					break;
+			}
+			std::cout << "Landmarks in top: " << landmarks.size() << std::endl;
+		}
+		return !landmarks.empty();
+    }
 
 public:    
     Algorithm(const std::string& alg_, dataStruc* ds_, const std::string& dtype_):
@@ -38,18 +80,86 @@ public:
 	dtype(dtype_),
 	ds(ds_),     
 	source(-1),
-	batch(-1) { 
+	batch(-1),
+	ranks(-1),
+	components(kNoLabel),
+	labels(kNoLabel),
+	depths(-1),
+	distances(-1),
+	widths(-1),
+	reach(0),
+	hops(unreachedHops()),
+	snapshot(nullptr) { 
 		is_adListST = (dtype.compare("adList") == 0);           
 		is_adList = (dtype.compare("adListShared") == 0);
 		is_stinger = (dtype.compare("stinger") == 0);
 		is_rhh = (dtype.compare("degAwareRHH") == 0);
 		is_adList2 = (dtype.compare("adListChunked") == 0);
+		is_csrDelta = (dtype.compare("csrDelta") == 0);
+		is_pcsr = (dtype.compare("pcsr") == 0);
+		is_compressed = (dtype.compare("adListCompressed") == 0);
+		is_edgeLog = (dtype.compare("edgeLog") == 0);
 		std::cout << "Algorithm: " << alg << std::endl;
 		std::cout << "Data type: " << dtype << std::endl;
     }
     
-    void performAlg() {
+    // result of the algorithm for vertex n
+    double property(NodeID n) const {
+		if (!ranks.empty())
+			return ranks[n];
+		if (!pr_push.empty())
+			return pr_push.estimate[n] / ds->num_nodes;
+		if (!ppr_walks.empty())
+			return ppr_walks.visits[n] * (1.0 - kDamp) / (kWalksPerVertex * ds->num_nodes);
+		if (!components.empty())
+			return components[n];
+		if (!labels.empty())
+			return labels[n];
+		if (!depths.empty())
+			return depths[n];
+		if (!distances.empty())
+			return distances[n];
+		if (!reach.empty())
+			return __builtin_popcountll(reach[n]);  // landmarks reaching n
+		return widths[n];
+    }
+
+    // top k vertices by PageRank personalized to s; pprdyn only
+    std::vector<std::pair<NodeID, double>> topPPR(NodeID s, int k) const {
+		return PPRTopK(ppr_walks, s, k);
+    }
+
+    // prints topPPR() for the source, picked like the BFS/SSSP one; pprdyn only
+    void printTopPPR(int k) {
+		if (ppr_walks.empty())
+			return;
+		if (source == -1) {
+			DynamicSourcePicker sp(ds);
+			source = sp.PickNext();
+			std::cout << "Source in top: " << source << std::endl;
+			if (source == -1)
+				return;
+		}
+		std::cout << "Top " << k << " PPR from " << source << ":" << std::endl;
+		for (const auto &v : topPPR(source, k))
+			std::cout << v.first << " " << v.second << std::endl;
+    }
+
+    bool fromScratch() const {
+		return alg.size() > 11 && alg.compare(alg.size() - 11, 11, "fromscratch") == 0;
+    }
+
+    // from-scratch algorithms run on snap instead of ds; it must be rebuilt
+    // with snapshotGraph() after every update
+    void setSnapshot(dataStruc* snap) {
+		snapshot = snap;
+    }
+
+    // el is the batch ds was just updated with
+    void performAlg(const EdgeList& el) {
 		batch++;
+		csrGraph<NodeWeight> *csr0 = dynamic_cast<csrGraph<NodeWeight>*>(snapshot);
+		csrGraph<Node> *csr1 = dynamic_cast<csrGraph<Node>*>(snapshot);
 		adListShared<NodeWeight> *ds0 = dynamic_cast<adListShared<NodeWeight>*>(ds);
 		adListShared<Node> *ds1 = dynamic_cast<adListShared<Node>*>(ds);
 		adListChunked<NodeWeight> *ds5 = dynamic_cast<adListChunked<NodeWeight>*>(ds);
@@ -59,6 +169,13 @@ public:
 		stinger *ds4 = dynamic_cast<stinger*>(ds);
 		adList<NodeWeight> *ds7 = dynamic_cast<adList<NodeWeight>*>(ds);
 		adList<Node> *ds8 = dynamic_cast<adList<Node>*>(ds);
+		csrDelta<NodeWeight> *ds9 = dynamic_cast<csrDelta<NodeWeight>*>(ds);
+		csrDelta<Node> *ds10 = dynamic_cast<csrDelta<Node>*>(ds);
+		pcsr<NodeWeight> *ds11 = dynamic_cast<pcsr<NodeWeight>*>(ds);
+		pcsr<Node> *ds12 = dynamic_cast<pcsr<Node>*>(ds);
+		adListCompressed *ds13 = dynamic_cast<adListCompressed*>(ds);
+		edgeLog<NodeWeight> *ds14 = dynamic_cast<edgeLog<NodeWeight>*>(ds);
+		edgeLog<Node> *ds15 = dynamic_cast<edgeLog<Node>*>(ds);
 	
 		if (alg == "traverse") {
 	 	    if (is_adList && ds->weighted)
@@ -79,120 +196,299 @@ public:
                 return traverseAlg(ds7);
 			else if (is_adListST && !ds->weighted) 
 			    return traverseAlg(ds8);
+			else if (is_csrDelta && ds->weighted)
+			    return traverseAlg(ds9);
+			else if (is_csrDelta && !ds->weighted)
+			    return traverseAlg(ds10);
+			else if (is_pcsr && ds->weighted)
+			    return traverseAlg(ds11);
+			else if (is_pcsr && !ds->weighted)
+			    return traverseAlg(ds12);
+			else if (is_compressed)
+			    return traverseAlg(ds13);
+			else if (is_edgeLog && ds->weighted)
+			    return traverseAlg(ds14);
+			else if (is_edgeLog && !ds->weighted)
+			    return traverseAlg(ds15);
 		} else if (alg == "prfromscratch") {
-	    	if (is_adList && ds->weighted)
-				return PRStartFromScratch(ds0);
+	    	if (csr0)
+				return PRStartFromScratch(csr0, ranks);
+	    	else if (csr1)
+				return PRStartFromScratch(csr1, ranks);
+	    	else if (is_adList && ds->weighted)
+				return PRStartFromScratch(ds0, ranks);
 	    	else if (is_adList && !ds->weighted)
-				return PRStartFromScratch(ds1);
+				return PRStartFromScratch(ds1, ranks);
 	    	else if (is_rhh && ds->weighted)
-				return PRStartFromScratch(ds2);
+				return PRStartFromScratch(ds2, ranks);
 	   		else if (is_rhh && !ds->weighted)
-				return PRStartFromScratch(ds3);
+				return PRStartFromScratch(ds3, ranks);
 	    	else if (is_stinger)
-				return PRStartFromScratch(ds4);
+				return PRStartFromScratch(ds4, ranks);
 	    	else if (is_adList2 && ds->weighted)
-				return PRStartFromScratch(ds5);
+				return PRStartFromScratch(ds5, ranks);
 	    	else if (is_adList2 && !ds->weighted)
-				return PRStartFromScratch(ds6);	
+				return PRStartFromScratch(ds6, ranks);	
 			else if (is_adListST && ds->weighted)
-                return PRStartFromScratch(ds7);
+                return PRStartFromScratch(ds7, ranks);
 			else if (is_adListST && !ds->weighted) 
-			    return PRStartFromScratch(ds8);    
+			    return PRStartFromScratch(ds8, ranks);
+			else if (is_csrDelta && ds->weighted)
+			    return PRStartFromScratch(ds9, ranks);
+			else if (is_csrDelta && !ds->weighted)
+			    return PRStartFromScratch(ds10, ranks);
+			else if (is_pcsr && ds->weighted)
+			    return PRStartFromScratch(ds11, ranks);
+			else if (is_pcsr && !ds->weighted)
+			    return PRStartFromScratch(ds12, ranks);
+			else if (is_compressed)
+			    return PRStartFromScratch(ds13, ranks);
+			else if (is_edgeLog && ds->weighted)
+			    return PRStartFromScratch(ds14, ranks);
+			else if (is_edgeLog && !ds->weighted)
+			    return PRStartFromScratch(ds15, ranks);    
 		} else if (alg == "prdyn") {
 	    	if (is_adList && ds->weighted)
-				return dynPRAlg(ds0);
+				return dynPRAlg(ds0, ranks, ws);
 	    	else if (is_adList && !ds->weighted)
-				return dynPRAlg(ds1);
+				return dynPRAlg(ds1, ranks, ws);
 	    	else if (is_rhh && ds->weighted)
-				return dynPRAlg(ds2);
+				return dynPRAlg(ds2, ranks, ws);
 	    	else if (is_rhh && !ds->weighted)
-				return dynPRAlg(ds3);
+				return dynPRAlg(ds3, ranks, ws);
 	    	else if (is_stinger)
-				return dynPRAlg(ds4);		
+				return dynPRAlg(ds4, ranks, ws);		
 	    	else if (is_adList2 && ds->weighted)
-				return dynPRAlg(ds5);
+				return dynPRAlg(ds5, ranks, ws);
 	    	else if (is_adList2 && !ds->weighted)
-				return dynPRAlg(ds6);	    
+				return dynPRAlg(ds6, ranks, ws);	    
 			else if (is_adListST && ds->weighted)
-                return dynPRAlg(ds7);
+                return dynPRAlg(ds7, ranks, ws);
 			else if (is_adListST && !ds->weighted) 
-			    return dynPRAlg(ds8);  
-		} else if (alg == "ccfromscratch") {
+			    return dynPRAlg(ds8, ranks, ws);
+			else if (is_csrDelta && ds->weighted)
+			    return dynPRAlg(ds9, ranks, ws);
+			else if (is_csrDelta && !ds->weighted)
+			    return dynPRAlg(ds10, ranks, ws);
+			else if (is_pcsr && ds->weighted)
+			    return dynPRAlg(ds11, ranks, ws);
+			else if (is_pcsr && !ds->weighted)
+			    return dynPRAlg(ds12, ranks, ws);
+			else if (is_compressed)
+			    return dynPRAlg(ds13, ranks, ws);
+			else if (is_edgeLog && ds->weighted)
+			    return dynPRAlg(ds14, ranks, ws);
+			else if (is_edgeLog && !ds->weighted)
+			    return dynPRAlg(ds15, ranks, ws);  
+		} else if (alg == "prpushdyn" || alg == "prpushasyncdyn") {
+			bool async = (alg == "prpushasyncdyn");
+	    	if (is_adList && ds->weighted)
+				return dynPRPushAlg(ds0, el, pr_push, async, ws);
+	    	else if (is_adList && !ds->weighted)
+				return dynPRPushAlg(ds1, el, pr_push, async, ws);
+	    	else if (is_rhh && ds->weighted)
+				return dynPRPushAlg(ds2, el, pr_push, async, ws);
+	    	else if (is_rhh && !ds->weighted)
+				return dynPRPushAlg(ds3, el, pr_push, async, ws);
+	    	else if (is_stinger)
+				return dynPRPushAlg(ds4, el, pr_push, async, ws);		
+	    	else if (is_adList2 && ds->weighted)
+				return dynPRPushAlg(ds5, el, pr_push, async, ws);
+	    	else if (is_adList2 && !ds->weighted)
+				return dynPRPushAlg(ds6, el, pr_push, async, ws);	    
+			else if (is_adListST && ds->weighted)
+                return dynPRPushAlg(ds7, el, pr_push, async, ws);
+			else if (is_adListST && !ds->weighted) 
+			    return dynPRPushAlg(ds8, el, pr_push, async, ws);
+			else if (is_csrDelta && ds->weighted)
+			    return dynPRPushAlg(ds9, el, pr_push, async, ws);
+			else if (is_csrDelta && !ds->weighted)
+			    return dynPRPushAlg(ds10, el, pr_push, async, ws);
+			else if (is_pcsr && ds->weighted)
+			    return dynPRPushAlg(ds11, el, pr_push, async, ws);
+			else if (is_pcsr && !ds->weighted)
+			    return dynPRPushAlg(ds12, el, pr_push, async, ws);
+			else if (is_compressed)
+			    return dynPRPushAlg(ds13, el, pr_push, async, ws);
+			else if (is_edgeLog && ds->weighted)
+			    return dynPRPushAlg(ds14, el, pr_push, async, ws);
+			else if (is_edgeLog && !ds->weighted)
+			    return dynPRPushAlg(ds15, el, pr_push, async, ws);  
+		} else if (alg == "pprdyn") {
 	    	if (is_adList && ds->weighted)
-				return CCStartFromScratch(ds0);
+				return dynPPRAlg(ds0, el, ppr_walks);
 	    	else if (is_adList && !ds->weighted)
-				return CCStartFromScratch(ds1);
+				return dynPPRAlg(ds1, el, ppr_walks);
 	    	else if (is_rhh && ds->weighted)
-				return CCStartFromScratch(ds2);
+				return dynPPRAlg(ds2, el, ppr_walks);
 	    	else if (is_rhh && !ds->weighted)
-				return CCStartFromScratch(ds3);
+				return dynPPRAlg(ds3, el, ppr_walks);
 	    	else if (is_stinger)
-				return CCStartFromScratch(ds4);
+				return dynPPRAlg(ds4, el, ppr_walks);		
 	    	else if (is_adList2 && ds->weighted)
-				return CCStartFromScratch(ds5);
+				return dynPPRAlg(ds5, el, ppr_walks);
 	    	else if (is_adList2 && !ds->weighted)
-				return CCStartFromScratch(ds6);	 
+				return dynPPRAlg(ds6, el, ppr_walks);	    
 			else if (is_adListST && ds->weighted)
-                return CCStartFromScratch(ds7);
+                return dynPPRAlg(ds7, el, ppr_walks);
 			else if (is_adListST && !ds->weighted) 
-			    return CCStartFromScratch(ds8);     
+			    return dynPPRAlg(ds8, el, ppr_walks);
+			else if (is_csrDelta && ds->weighted)
+			    return dynPPRAlg(ds9, el, ppr_walks);
+			else if (is_csrDelta && !ds->weighted)
+			    return dynPPRAlg(ds10, el, ppr_walks);
+			else if (is_pcsr && ds->weighted)
+			    return dynPPRAlg(ds11, el, ppr_walks);
+			else if (is_pcsr && !ds->weighted)
+			    return dynPPRAlg(ds12, el, ppr_walks);
+			else if (is_compressed)
+			    return dynPPRAlg(ds13, el, ppr_walks);
+			else if (is_edgeLog && ds->weighted)
+			    return dynPPRAlg(ds14, el, ppr_walks);
+			else if (is_edgeLog && !ds->weighted)
+			    return dynPPRAlg(ds15, el, ppr_walks);  
+		} else if (alg == "ccfromscratch") {
+	    	if (csr0)
+				return CCStartFromScratch(csr0, components);
+	    	else if (csr1)
+				return CCStartFromScratch(csr1, components);
+	    	else if (is_adList && ds->weighted)
+				return CCStartFromScratch(ds0, components);
+	    	else if (is_adList && !ds->weighted)
+				return CCStartFromScratch(ds1, components);
+	    	else if (is_rhh && ds->weighted)
+				return CCStartFromScratch(ds2, components);
+	    	else if (is_rhh && !ds->weighted)
+				return CCStartFromScratch(ds3, components);
+	    	else if (is_stinger)
+				return CCStartFromScratch(ds4, components);
+	    	else if (is_adList2 && ds->weighted)
+				return CCStartFromScratch(ds5, components);
+	    	else if (is_adList2 && !ds->weighted)
+				return CCStartFromScratch(ds6, components);	 
+			else if (is_adListST && ds->weighted)
+                return CCStartFromScratch(ds7, components);
+			else if (is_adListST && !ds->weighted) 
+			    return CCStartFromScratch(ds8, components);
+			else if (is_csrDelta && ds->weighted)
+			    return CCStartFromScratch(ds9, components);
+			else if (is_csrDelta && !ds->weighted)
+			    return CCStartFromScratch(ds10, components);
+			else if (is_pcsr && ds->weighted)
+			    return CCStartFromScratch(ds11, components);
+			else if (is_pcsr && !ds->weighted)
+			    return CCStartFromScratch(ds12, components);
+			else if (is_compressed)
+			    return CCStartFromScratch(ds13, components);
+			else if (is_edgeLog && ds->weighted)
+			    return CCStartFromScratch(ds14, components);
+			else if (is_edgeLog && !ds->weighted)
+			    return CCStartFromScratch(ds15, components);     
+		} else if (alg == "ccufdyn") {
+			return dynCCUnionFindAlg(ds, el, components);
 		} else if (alg == "ccdyn") {
 	    	if (is_adList && ds->weighted)
-				return dynCCAlg(ds0);
+				return dynCCAlg(ds0, components, ws);
 	    	else if (is_adList && !ds->weighted)
-				return dynCCAlg(ds1);
+				return dynCCAlg(ds1, components, ws);
 	    	else if (is_rhh && ds->weighted)
-				return dynCCAlg(ds2);
+				return dynCCAlg(ds2, components, ws);
 	    	else if (is_rhh && !ds->weighted)
-		  		return dynCCAlg(ds3);
+		  		return dynCCAlg(ds3, components, ws);
 	    	else if (is_stinger)
-				return dynCCAlg(ds4);		
+				return dynCCAlg(ds4, components, ws);		
 	    	else if (is_adList2 && ds->weighted)
-				return dynCCAlg(ds5);
+				return dynCCAlg(ds5, components, ws);
 	    	else if (is_adList2 && !ds->weighted)
-				return dynCCAlg(ds6);	
+				return dynCCAlg(ds6, components, ws);	
 			else if (is_adListST && ds->weighted)
-                return dynCCAlg(ds7);
+                return dynCCAlg(ds7, components, ws);
 			else if (is_adListST && !ds->weighted) 
-			    return dynCCAlg(ds8);    
+			    return dynCCAlg(ds8, components, ws);
+			else if (is_csrDelta && ds->weighted)
+			    return dynCCAlg(ds9, components, ws);
+			else if (is_csrDelta && !ds->weighted)
+			    return dynCCAlg(ds10, components, ws);
+			else if (is_pcsr && ds->weighted)
+			    return dynCCAlg(ds11, components, ws);
+			else if (is_pcsr && !ds->weighted)
+			    return dynCCAlg(ds12, components, ws);
+			else if (is_compressed)
+			    return dynCCAlg(ds13, components, ws);
+			else if (is_edgeLog && ds->weighted)
+			    return dynCCAlg(ds14, components, ws);
+			else if (is_edgeLog && !ds->weighted)
+			    return dynCCAlg(ds15, components, ws);    
 		} else if (alg == "mcfromscratch") {
-	    	if (is_adList && ds->weighted)
-				return MCStartFromScratch(ds0);
+	    	if (csr0)
+				return MCStartFromScratch(csr0, labels);
+	    	else if (csr1)
+				return MCStartFromScratch(csr1, labels);
+	    	else if (is_adList && ds->weighted)
+				return MCStartFromScratch(ds0, labels);
 	    	else if (is_adList && !ds->weighted)
-				return MCStartFromScratch(ds1);
+				return MCStartFromScratch(ds1, labels);
 	    	else if (is_rhh && ds->weighted)
-				return MCStartFromScratch(ds2);
+				return MCStartFromScratch(ds2, labels);
 	    	else if (is_rhh && !ds->weighted)
-				return MCStartFromScratch(ds3);
+				return MCStartFromScratch(ds3, labels);
 	    	else if (is_stinger)
-				return MCStartFromScratch(ds4);			
+				return MCStartFromScratch(ds4, labels);			
 	    	else if (is_adList2 && ds->weighted)
-				return MCStartFromScratch(ds5);
+				return MCStartFromScratch(ds5, labels);
 	    	else if (is_adList2 && !ds->weighted)
-				return MCStartFromScratch(ds6);   
+				return MCStartFromScratch(ds6, labels);   
 			else if (is_adListST && ds->weighted)
-                return MCStartFromScratch(ds7);
+                return MCStartFromScratch(ds7, labels);
 			else if (is_adListST && !ds->weighted) 
-			    return MCStartFromScratch(ds8);    
+			    return MCStartFromScratch(ds8, labels);
+			else if (is_csrDelta && ds->weighted)
+			    return MCStartFromScratch(ds9, labels);
+			else if (is_csrDelta && !ds->weighted)
+			    return MCStartFromScratch(ds10, labels);
+			else if (is_pcsr && ds->weighted)
+			    return MCStartFromScratch(ds11, labels);
+			else if (is_pcsr && !ds->weighted)
+			    return MCStartFromScratch(ds12, labels);
+			else if (is_compressed)
+			    return MCStartFromScratch(ds13, labels);
+			else if (is_edgeLog && ds->weighted)
+			    return MCStartFromScratch(ds14, labels);
+			else if (is_edgeLog && !ds->weighted)
+			    return MCStartFromScratch(ds15, labels);    
 		} else if (alg == "mcdyn") {
 	    	if (is_adList && ds->weighted)
-				return dynMCAlg(ds0);
+				return dynMCAlg(ds0, labels, ws);
 	    	else if (is_adList && !ds->weighted)
-				return dynMCAlg(ds1);
+				return dynMCAlg(ds1, labels, ws);
 	    	else if (is_rhh && ds->weighted)
-				return dynMCAlg(ds2);
+				return dynMCAlg(ds2, labels, ws);
 	    	else if (is_rhh && !ds->weighted)
-				return dynMCAlg(ds3);
+				return dynMCAlg(ds3, labels, ws);
 	    	else if (is_stinger)
-				return dynMCAlg(ds4);		
+				return dynMCAlg(ds4, labels, ws);		
 	    	else if (is_adList2 && ds->weighted)
-				return dynMCAlg(ds5);
+				return dynMCAlg(ds5, labels, ws);
 	    	else if (is_adList2 && !ds->weighted)
-				return dynMCAlg(ds6);	   
+				return dynMCAlg(ds6, labels, ws);	   
 			else if (is_adListST && ds->weighted)
-                return dynMCAlg(ds7);
+                return dynMCAlg(ds7, labels, ws);
 			else if (is_adListST && !ds->weighted) 
-			    return dynMCAlg(ds8); 
+			    return dynMCAlg(ds8, labels, ws);
+			else if (is_csrDelta && ds->weighted)
+			    return dynMCAlg(ds9, labels, ws);
+			else if (is_csrDelta && !ds->weighted)
+			    return dynMCAlg(ds10, labels, ws);
+			else if (is_pcsr && ds->weighted)
+			    return dynMCAlg(ds11, labels, ws);
+			else if (is_pcsr && !ds->weighted)
+			    return dynMCAlg(ds12, labels, ws);
+			else if (is_compressed)
+			    return dynMCAlg(ds13, labels, ws);
+			else if (is_edgeLog && ds->weighted)
+			    return dynMCAlg(ds14, labels, ws);
+			else if (is_edgeLog && !ds->weighted)
+			    return dynMCAlg(ds15, labels, ws); 
 		} else if (alg == "bfsfromscratch") {
 	    	if (source == -1) {
 				DynamicSourcePicker sp(ds);
@@ -201,24 +497,42 @@ public:
 			if(source == -1)
 		    	return;
 	    	}
-	    	if (is_adList && ds->weighted)
-				return BFSStartFromScratch(ds0, source);
+	    	if (csr0)
+				return BFSStartFromScratch(csr0, depths, source);
+	    	else if (csr1)
+				return BFSStartFromScratch(csr1, depths, source);
+	    	else if (is_adList && ds->weighted)
+				return BFSStartFromScratch(ds0, depths, source);
 	    	else if (is_adList && !ds->weighted)
-				return BFSStartFromScratch(ds1, source);
+				return BFSStartFromScratch(ds1, depths, source);
 	    	else if (is_rhh && ds->weighted)
-				return BFSStartFromScratch(ds2, source);
+				return BFSStartFromScratch(ds2, depths, source);
 	    	else if (is_rhh && !ds->weighted)
-				return BFSStartFromScratch(ds3, source);
+				return BFSStartFromScratch(ds3, depths, source);
 	    	else if (is_stinger)
-				return BFSStartFromScratch(ds4, source);			
+				return BFSStartFromScratch(ds4, depths, source);			
 	    	else if (is_adList2 && ds->weighted)
-				return BFSStartFromScratch(ds5, source);
+				return BFSStartFromScratch(ds5, depths, source);
 	    	else if (is_adList2 && !ds->weighted)
-				return BFSStartFromScratch(ds6, source);   
+				return BFSStartFromScratch(ds6, depths, source);   
 			else if (is_adListST && ds->weighted)
-                return BFSStartFromScratch(ds7, source);
+                return BFSStartFromScratch(ds7, depths, source);
 			else if (is_adListST && !ds->weighted) 
-			    return BFSStartFromScratch(ds8, source);  
+			    return BFSStartFromScratch(ds8, depths, source);
+			else if (is_csrDelta && ds->weighted)
+			    return BFSStartFromScratch(ds9, depths, source);
+			else if (is_csrDelta && !ds->weighted)
+			    return BFSStartFromScratch(ds10, depths, source);
+			else if (is_pcsr && ds->weighted)
+			    return BFSStartFromScratch(ds11, depths, source);
+			else if (is_pcsr && !ds->weighted)
+			    return BFSStartFromScratch(ds12, depths, source);
+			else if (is_compressed)
+			    return BFSStartFromScratch(ds13, depths, source);
+			else if (is_edgeLog && ds->weighted)
+			    return BFSStartFromScratch(ds14, depths, source);
+			else if (is_edgeLog && !ds->weighted)
+			    return BFSStartFromScratch(ds15, depths, source);  
 		} else if (alg == "bfsdyn") {
 	    	if(source == -1){
 				DynamicSourcePicker sp(ds);
@@ -228,23 +542,37 @@ public:
 		    		return;
 	   		}
 	    	if (is_adList && ds->weighted)
-				return dynBFSAlg(ds0, source);
+				return dynBFSAlg(ds0, depths, source, ws);
 	    	else if (is_adList && !ds->weighted)
-				return dynBFSAlg(ds1, source);
+				return dynBFSAlg(ds1, depths, source, ws);
 	    	else if (is_rhh && ds->weighted)
-				return dynBFSAlg(ds2, source);
+				return dynBFSAlg(ds2, depths, source, ws);
 	    	else if (is_rhh && !ds->weighted)
-				return dynBFSAlg(ds3, source);
+				return dynBFSAlg(ds3, depths, source, ws);
 	    	else if (is_stinger)
-				return dynBFSAlg(ds4, source);	 
+				return dynBFSAlg(ds4, depths, source, ws);	 
 	    	else if (is_adList2 && ds->weighted)
-				return dynBFSAlg(ds5, source);
+				return dynBFSAlg(ds5, depths, source, ws);
 	    	else if (is_adList2 && !ds->weighted)
-				return dynBFSAlg(ds6, source);  
+				return dynBFSAlg(ds6, depths, source, ws);  
 			else if (is_adListST && ds->weighted)
-                return dynBFSAlg(ds7, source);
+                return dynBFSAlg(ds7, depths, source, ws);
 			else if (is_adListST && !ds->weighted) 
-			    return dynBFSAlg(ds8, source);
+			    return dynBFSAlg(ds8, depths, source, ws);
+			else if (is_csrDelta && ds->weighted)
+			    return dynBFSAlg(ds9, depths, source, ws);
+			else if (is_csrDelta && !ds->weighted)
+			    return dynBFSAlg(ds10, depths, source, ws);
+			else if (is_pcsr && ds->weighted)
+			    return dynBFSAlg(ds11, depths, source, ws);
+			else if (is_pcsr && !ds->weighted)
+			    return dynBFSAlg(ds12, depths, source, ws);
+			else if (is_compressed)
+			    return dynBFSAlg(ds13, depths, source, ws);
+			else if (is_edgeLog && ds->weighted)
+			    return dynBFSAlg(ds14, depths, source, ws);
+			else if (is_edgeLog && !ds->weighted)
+			    return dynBFSAlg(ds15, depths, source, ws);
 		} else if (alg == "ssspfromscratch") {
 	    	if (source == -1) {
 				DynamicSourcePicker sp(ds);
@@ -253,24 +581,42 @@ public:
 				if(source == -1)
 		    	return;
 	    	}
-	    	if (is_adList && ds->weighted)
-				return SSSPStartFromScratch(ds0, source, 1);
+	    	if (csr0)
+				return SSSPStartFromScratch(csr0, distances, source, 1);
+	    	else if (csr1)
+				return SSSPStartFromScratch(csr1, distances, source, 1);
+	    	else if (is_adList && ds->weighted)
+				return SSSPStartFromScratch(ds0, distances, source, 1);
 	    	else if (is_adList && !ds->weighted)
-				return SSSPStartFromScratch(ds1, source, 1);
+				return SSSPStartFromScratch(ds1, distances, source, 1);
 	   		else if (is_rhh && ds->weighted)
-				return SSSPStartFromScratch(ds2, source, 1);
+				return SSSPStartFromScratch(ds2, distances, source, 1);
 	    	else if (is_rhh && !ds->weighted)
-				return SSSPStartFromScratch(ds3, source, 1);
+				return SSSPStartFromScratch(ds3, distances, source, 1);
 	    	else if (is_stinger)
-				return SSSPStartFromScratch(ds4, source, 1);	    
+				return SSSPStartFromScratch(ds4, distances, source, 1);	    
 	    	else if (is_adList2 && ds->weighted)
-				return SSSPStartFromScratch(ds5, source, 1);
+				return SSSPStartFromScratch(ds5, distances, source, 1);
 	    	else if (is_adList2 && !ds->weighted)
-				return SSSPStartFromScratch(ds6, source, 1);
+				return SSSPStartFromScratch(ds6, distances, source, 1);
 			else if (is_adListST && ds->weighted)
-                return SSSPStartFromScratch(ds7, source, 1);
+                return SSSPStartFromScratch(ds7, distances, source, 1);
 			else if (is_adListST && !ds->weighted) 
-			    return SSSPStartFromScratch(ds8, source, 1);
+			    return SSSPStartFromScratch(ds8, distances, source, 1);
+			else if (is_csrDelta && ds->weighted)
+			    return SSSPStartFromScratch(ds9, distances, source, 1);
+			else if (is_csrDelta && !ds->weighted)
+			    return SSSPStartFromScratch(ds10, distances, source, 1);
+			else if (is_pcsr && ds->weighted)
+			    return SSSPStartFromScratch(ds11, distances, source, 1);
+			else if (is_pcsr && !ds->weighted)
+			    return SSSPStartFromScratch(ds12, distances, source, 1);
+			else if (is_compressed)
+			    return SSSPStartFromScratch(ds13, distances, source, 1);
+			else if (is_edgeLog && ds->weighted)
+			    return SSSPStartFromScratch(ds14, distances, source, 1);
+			else if (is_edgeLog && !ds->weighted)
+			    return SSSPStartFromScratch(ds15, distances, source, 1);
 		} else if (alg == "ssspdyn") {
 		    if (source == -1) {
 				DynamicSourcePicker sp(ds);
@@ -280,23 +626,37 @@ public:
 		    		return;
 	    	}
 	    	if (is_adList && ds->weighted)
-				return dynSSSPAlg(ds0, source);
+				return dynSSSPAlg(ds0, distances, source, ws);
 	    	else if (is_adList && !ds->weighted)
-				return dynSSSPAlg(ds1, source);
+				return dynSSSPAlg(ds1, distances, source, ws);
 	    	else if (is_rhh && ds->weighted)
-				return dynSSSPAlg(ds2, source);
+				return dynSSSPAlg(ds2, distances, source, ws);
 	    	else if (is_rhh && !ds->weighted)
-				return dynSSSPAlg(ds3, source);
+				return dynSSSPAlg(ds3, distances, source, ws);
 	    	else if (is_stinger)
-				return dynSSSPAlg(ds4, source);	   
+				return dynSSSPAlg(ds4, distances, source, ws);	   
 	    	else if (is_adList2 && ds->weighted)
-				return dynSSSPAlg(ds5, source);
+				return dynSSSPAlg(ds5, distances, source, ws);
 	    	else if (is_adList2 && !ds->weighted)
-				return dynSSSPAlg(ds6, source);
+				return dynSSSPAlg(ds6, distances, source, ws);
 			else if (is_adListST && ds->weighted)
-                return dynSSSPAlg(ds7, source);
+                return dynSSSPAlg(ds7, distances, source, ws);
 			else if (is_adListST && !ds->weighted) 
-			    return dynSSSPAlg(ds8, source);
+			    return dynSSSPAlg(ds8, distances, source, ws);
+			else if (is_csrDelta && ds->weighted)
+			    return dynSSSPAlg(ds9, distances, source, ws);
+			else if (is_csrDelta && !ds->weighted)
+			    return dynSSSPAlg(ds10, distances, source, ws);
+			else if (is_pcsr && ds->weighted)
+			    return dynSSSPAlg(ds11, distances, source, ws);
+			else if (is_pcsr && !ds->weighted)
+			    return dynSSSPAlg(ds12, distances, source, ws);
+			else if (is_compressed)
+			    return dynSSSPAlg(ds13, distances, source, ws);
+			else if (is_edgeLog && ds->weighted)
+			    return dynSSSPAlg(ds14, distances, source, ws);
+			else if (is_edgeLog && !ds->weighted)
+			    return dynSSSPAlg(ds15, distances, source, ws);
 		} else if (alg == "sswpfromscratch") {
 	    	if (source == -1) {
 				DynamicSourcePicker sp(ds);
@@ -305,24 +665,42 @@ public:
 				if(source == -1)
 				    return;
 	    	}
-	    	if (is_adList && ds->weighted)
-				return SSWPStartFromScratch(ds0, source);
+	    	if (csr0)
+				return SSWPStartFromScratch(csr0, widths, source);
+	    	else if (csr1)
+				return SSWPStartFromScratch(csr1, widths, source);
+	    	else if (is_adList && ds->weighted)
+				return SSWPStartFromScratch(ds0, widths, source);
 	    	else if (is_adList && !ds->weighted)
-				return SSWPStartFromScratch(ds1, source);
+				return SSWPStartFromScratch(ds1, widths, source);
 	    	else if (is_rhh && ds->weighted)
-				return SSWPStartFromScratch(ds2, source);
+				return SSWPStartFromScratch(ds2, widths, source);
 	    	else if (is_rhh && !ds->weighted)
-				return SSWPStartFromScratch(ds3, source);
+				return SSWPStartFromScratch(ds3, widths, source);
 	    	else if (is_stinger)
-				return SSWPStartFromScratch(ds4, source);	   
+				return SSWPStartFromScratch(ds4, widths, source);	   
 	    	else if (is_adList2 && ds->weighted)
-				return SSWPStartFromScratch(ds5, source);
+				return SSWPStartFromScratch(ds5, widths, source);
 	    	else if (is_adList2 && !ds->weighted)
-				return SSWPStartFromScratch(ds6, source);
+				return SSWPStartFromScratch(ds6, widths, source);
 			else if (is_adListST && ds->weighted)
-                return SSWPStartFromScratch(ds7, source);
+                return SSWPStartFromScratch(ds7, widths, source);
 			else if (is_adListST && !ds->weighted) 
-			    return SSWPStartFromScratch(ds8, source);
+			    return SSWPStartFromScratch(ds8, widths, source);
+			else if (is_csrDelta && ds->weighted)
+			    return SSWPStartFromScratch(ds9, widths, source);
+			else if (is_csrDelta && !ds->weighted)
+			    return SSWPStartFromScratch(ds10, widths, source);
+			else if (is_pcsr && ds->weighted)
+			    return SSWPStartFromScratch(ds11, widths, source);
+			else if (is_pcsr && !ds->weighted)
+			    return SSWPStartFromScratch(ds12, widths, source);
+			else if (is_compressed)
+			    return SSWPStartFromScratch(ds13, widths, source);
+			else if (is_edgeLog && ds->weighted)
+			    return SSWPStartFromScratch(ds14, widths, source);
+			else if (is_edgeLog && !ds->weighted)
+			    return SSWPStartFromScratch(ds15, widths, source);
 		} else if (alg == "sswpdyn") {
 	    	if(source == -1) {
 				DynamicSourcePicker sp(ds);
@@ -332,23 +710,111 @@ public:
 				    return;
 	    	}
 	    	if (is_adList && ds->weighted)
-				return dynSSWPAlg(ds0, source);
+				return dynSSWPAlg(ds0, widths, source, ws);
+	    	else if (is_adList && !ds->weighted)
+				return dynSSWPAlg(ds1, widths, source, ws);
+	    	else if (is_rhh && ds->weighted)
+				return dynSSWPAlg(ds2, widths, source, ws);
+	    	else if (is_rhh && !ds->weighted)
+				return dynSSWPAlg(ds3, widths, source, ws);
+	    	else if (is_stinger)
+				return dynSSWPAlg(ds4, widths, source, ws);	    
+	    	else if (is_adList2 && ds->weighted)
+				return dynSSWPAlg(ds5, widths, source, ws);
+	    	else if (is_adList2 && !ds->weighted)
+				return dynSSWPAlg(ds6, widths, source, ws);
+			else if (is_adListST && ds->weighted)
+                return dynSSWPAlg(ds7, widths, source, ws);
+			else if (is_adListST && !ds->weighted) 
+			    return dynSSWPAlg(ds8, widths, source, ws);
+			else if (is_csrDelta && ds->weighted)
+			    return dynSSWPAlg(ds9, widths, source, ws);
+			else if (is_csrDelta && !ds->weighted)
+			    return dynSSWPAlg(ds10, widths, source, ws);
+			else if (is_pcsr && ds->weighted)
+			    return dynSSWPAlg(ds11, widths, source, ws);
+			else if (is_pcsr && !ds->weighted)
+			    return dynSSWPAlg(ds12, widths, source, ws);
+			else if (is_compressed)
+			    return dynSSWPAlg(ds13, widths, source, ws);
+			else if (is_edgeLog && ds->weighted)
+			    return dynSSWPAlg(ds14, widths, source, ws);
+			else if (is_edgeLog && !ds->weighted)
+			    return dynSSWPAlg(ds15, widths, source, ws);
+		} else if (alg == "msbfsfromscratch") {
+	    	if (!pickLandmarks())
+				return;
+	    	if (csr0)
+				return MSBFSStartFromScratch(csr0, reach, hops, landmarks);
+	    	else if (csr1)
+				return MSBFSStartFromScratch(csr1, reach, hops, landmarks);
+	    	else if (is_adList && ds->weighted)
+				return MSBFSStartFromScratch(ds0, reach, hops, landmarks);
+	    	else if (is_adList && !ds->weighted)
+				return MSBFSStartFromScratch(ds1, reach, hops, landmarks);
+	    	else if (is_rhh && ds->weighted)
+				return MSBFSStartFromScratch(ds2, reach, hops, landmarks);
+	    	else if (is_rhh && !ds->weighted)
+				return MSBFSStartFromScratch(ds3, reach, hops, landmarks);
+	    	else if (is_stinger)
+				return MSBFSStartFromScratch(ds4, reach, hops, landmarks);	 
+	    	else if (is_adList2 && ds->weighted)
+				return MSBFSStartFromScratch(ds5, reach, hops, landmarks);
+	    	else if (is_adList2 && !ds->weighted)
+				return MSBFSStartFromScratch(ds6, reach, hops, landmarks);  
+			else if (is_adListST && ds->weighted)
+                return MSBFSStartFromScratch(ds7, reach, hops, landmarks);
+			else if (is_adListST && !ds->weighted) 
+			    return MSBFSStartFromScratch(ds8, reach, hops, landmarks);
+			else if (is_csrDelta && ds->weighted)
+			    return MSBFSStartFromScratch(ds9, reach, hops, landmarks);
+			else if (is_csrDelta && !ds->weighted)
+			    return MSBFSStartFromScratch(ds10, reach, hops, landmarks);
+			else if (is_pcsr && ds->weighted)
+			    return MSBFSStartFromScratch(ds11, reach, hops, landmarks);
+			else if (is_pcsr && !ds->weighted)
+			    return MSBFSStartFromScratch(ds12, reach, hops, landmarks);
+			else if (is_compressed)
+			    return MSBFSStartFromScratch(ds13, reach, hops, landmarks);
+			else if (is_edgeLog && ds->weighted)
+			    return MSBFSStartFromScratch(ds14, reach, hops, landmarks);
+			else if (is_edgeLog && !ds->weighted)
+			    return MSBFSStartFromScratch(ds15, reach, hops, landmarks);
+		} else if (alg == "msbfsdyn") {
+	    	if (!pickLandmarks())
+				return;
+	    	if (is_adList && ds->weighted)
+				return dynMSBFSAlg(ds0, reach, hops, landmarks, ws);
 	    	else if (is_adList && !ds->weighted)
-				return dynSSWPAlg(ds1, source);
+				return dynMSBFSAlg(ds1, reach, hops, landmarks, ws);
 	    	else if (is_rhh && ds->weighted)
-				return dynSSWPAlg(ds2, source);
+				return dynMSBFSAlg(ds2, reach, hops, landmarks, ws);
 	    	else if (is_rhh && !ds->weighted)
-				return dynSSWPAlg(ds3, source);
+				return dynMSBFSAlg(ds3, reach, hops, landmarks, ws);
 	    	else if (is_stinger)
-				return dynSSWPAlg(ds4, source);	    
+				return dynMSBFSAlg(ds4, reach, hops, landmarks, ws);	 
 	    	else if (is_adList2 && ds->weighted)
-				return dynSSWPAlg(ds5, source);
+				return dynMSBFSAlg(ds5, reach, hops, landmarks, ws);
 	    	else if (is_adList2 && !ds->weighted)
-				return dynSSWPAlg(ds6, source);
+				return dynMSBFSAlg(ds6, reach, hops, landmarks, ws);  
 			else if (is_adListST && ds->weighted)
-                return dynSSWPAlg(ds7, source);
+                return dynMSBFSAlg(ds7, reach, hops, landmarks, ws);
 			else if (is_adListST && !ds->weighted) 
-			    return dynSSWPAlg(ds8, source);
+			    return dynMSBFSAlg(ds8, reach, hops, landmarks, ws);
+			else if (is_csrDelta && ds->weighted)
+			    return dynMSBFSAlg(ds9, reach, hops, landmarks, ws);
+			else if (is_csrDelta && !ds->weighted)
+			    return dynMSBFSAlg(ds10, reach, hops, landmarks, ws);
+			else if (is_pcsr && ds->weighted)
+			    return dynMSBFSAlg(ds11, reach, hops, landmarks, ws);
+			else if (is_pcsr && !ds->weighted)
+			    return dynMSBFSAlg(ds12, reach, hops, landmarks, ws);
+			else if (is_compressed)
+			    return dynMSBFSAlg(ds13, reach, hops, landmarks, ws);
+			else if (is_edgeLog && ds->weighted)
+			    return dynMSBFSAlg(ds14, reach, hops, landmarks, ws);
+			else if (is_edgeLog && !ds->weighted)
+			    return dynMSBFSAlg(ds15, reach, hops, landmarks, ws);
 		} else {
 	    	std::cout << "Error! Unrecognized Algorithm!" << std::endl;
 	    	exit(0);
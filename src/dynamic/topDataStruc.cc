@@ -1,6 +1,6 @@
 #include "topDataStruc.h"
 
-dataStruc* createDataStruc(const std::string& type, bool weighted, bool directed, int64_t num_nodes, int64_t num_threads)
+dataStruc* createDataStruc(const std::string& type, bool weighted, bool directed, int64_t num_nodes, int64_t num_threads, int64_t edges_per_block, int64_t ld_threshold)
 {        
     if (type == "adList") {
       if (weighted)
@@ -19,11 +19,28 @@ dataStruc* createDataStruc(const std::string& type, bool weighted, bool directed
             return new adListChunked<Node>(weighted, directed, num_nodes, num_threads);
     } else if (type == "degAwareRHH") {
 	if (weighted)
-	    return new darhh<NodeWeight>(weighted, directed, num_nodes, num_threads);
+	    return new darhh<NodeWeight>(weighted, directed, num_nodes, num_threads, ld_threshold);
 	else
-	    return new darhh<Node>(weighted, directed, num_nodes, num_threads);
+	    return new darhh<Node>(weighted, directed, num_nodes, num_threads, ld_threshold);
     } else if(type == "stinger") {
-        return new stinger(weighted, directed, num_nodes);         
+        return new stinger(weighted, directed, num_nodes, edges_per_block);         
+    } else if (type == "csrDelta") {
+        if (weighted)
+            return new csrDelta<NodeWeight>(weighted, directed, num_nodes);
+        else
+            return new csrDelta<Node>(weighted, directed, num_nodes);
+    } else if (type == "pcsr") {
+        if (weighted)
+            return new pcsr<NodeWeight>(weighted, directed, num_nodes);
+        else
+            return new pcsr<Node>(weighted, directed, num_nodes);
+    } else if (type == "adListCompressed") {
+        return new adListCompressed(weighted, directed, num_nodes);
+    } else if (type == "edgeLog") {
+        if (weighted)
+            return new edgeLog<NodeWeight>(weighted, directed, num_nodes);
+        else
+            return new edgeLog<Node>(weighted, directed, num_nodes);
     }else{
         cout << "ERROR! Unrecognized Data Structure Type!" << endl;
     } 
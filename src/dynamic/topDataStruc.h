@@ -8,6 +8,10 @@
 #include "stinger.h"
 #include "darhh.h"
 #include "adListChunked.h"
+#include "csrDelta.h"
+#include "pcsr.h"
+#include "adListCompressed.h"
+#include "edgeLog.h"
 
-dataStruc* createDataStruc(const std::string& type, bool weighted, bool directed, int64_t num_nodes, int64_t num_threads);
+dataStruc* createDataStruc(const std::string& type, bool weighted, bool directed, int64_t num_nodes, int64_t num_threads, int64_t edges_per_block, int64_t ld_threshold);
 #endif
\ No newline at end of file
@@ -6,6 +6,11 @@
 #include "stinger.h"
 #include "darhh.h"
 #include "adListChunked.h"
+#include "csrDelta.h"
+#include "pcsr.h"
+#include "adListCompressed.h"
+#include "edgeLog.h"
+#include "csrGraph.h"
 
 #include "topDataStruc.h"
 
@@ -169,37 +174,12 @@ class neighborhood_iter<stinger> {
       stinger* ds;      
       NodeID node;
       bool in_neigh;
-      stinger_edge* cursor;
+      NodeID* cursor;          /**< walks the neighbor array only, weights are read on demand */
       stinger_eb* curr_eb;
       stinger_vertex* sv;
-      int cursor_index;
+      int64_t cursor_index;
 
-    public:
-      neighborhood_iter(stinger* _ds, NodeID _n, bool _in_neigh)
-      :ds(_ds), node(_n), in_neigh(_in_neigh)
-      {
-          sv = &(ds->vertices[node]);
-
-          if(in_neigh){              
-              bool empty = (sv->in_neighbors->numEdges == 0); 
-              cursor = empty? 0 : &(sv->in_neighbors->edges[0]);
-              curr_eb = sv->in_neighbors;
-              if(!empty) cursor_index = 0;
-          }
-
-          else{
-              bool empty = (sv->out_neighbors->numEdges == 0); 
-              cursor = empty? 0 : &(sv->out_neighbors->edges[0]);
-              curr_eb = sv->out_neighbors;
-              if(!empty) cursor_index = 0;
-          }
-      }
-
-      bool operator!=(const neighborhood_iter<stinger>& it){
-          return cursor != it.cursor;
-      }
-
-      neighborhood_iter& operator++(){
+      void next(){
           // just increment by 1 if we are in an edgeblock and more edges left           
           if(cursor_index < (curr_eb->numEdges-1)){
               cursor = cursor + 1;
@@ -211,47 +191,48 @@ class neighborhood_iter<stinger> {
               if(curr_eb->next != nullptr){                  
                   // move to next one, if there is one
                   curr_eb = curr_eb->next;
-                  cursor = &(curr_eb->edges[0]);
+                  cursor = curr_eb->neighbors;
                   cursor_index = 0;
               }else{
                   // there is no further, end of traversal
                   cursor = nullptr;
               }              
           }        
+      }
 
-          return *this;          
+    public:
+      neighborhood_iter(stinger* _ds, NodeID _n, bool _in_neigh)
+      :ds(_ds), node(_n), in_neigh(_in_neigh), cursor_index(0)
+      {
+          sv = &(ds->vertices[node]);
+
+          // edge blocks are allocated on the first edge, so the head may be null
+          curr_eb = in_neigh? sv->in_neighbors : sv->out_neighbors;
+          bool empty = (curr_eb == nullptr) || (curr_eb->numEdges == 0); 
+          cursor = empty? nullptr : curr_eb->neighbors;
       }
 
-      neighborhood_iter& operator++(int){
-          // just increment by 1 if we are in an edgeblock and more edges left           
-          if(cursor_index < (curr_eb->numEdges-1)){              
-              cursor = cursor + 1;
-              cursor_index++;
-          }
+      bool operator!=(const neighborhood_iter<stinger>& it){
+          return cursor != it.cursor;
+      }
 
-          else if(cursor_index == (curr_eb->numEdges-1)){
-              // We are done with current edgeblock 
-              if(curr_eb->next != nullptr){                  
-                  // move to next one, if there is one
-                  curr_eb = curr_eb->next;
-                  cursor = &(curr_eb->edges[0]);
-                  cursor_index = 0;
-              }else{                  
-                  // there is no further, end of traversal
-                  cursor = nullptr;
-              }              
-          }        
+      neighborhood_iter& operator++(){
+          next();
+          return *this;          
+      }
 
+      neighborhood_iter& operator++(int){
+          next();
           return *this; 
       }      
 
       NodeID operator*(){
-          assert(cursor->neighbor != -1);
-          return cursor->neighbor;
+          assert(*cursor != -1);
+          return *cursor;
       }
 
       Weight extractWeight(){
-          return cursor->weight;
+          return curr_eb->weights[cursor_index];
       }
 };
 
@@ -439,6 +420,286 @@ Weight neighborhood_iter<darhh<U>>::extractWeight()
 	return hd_iter.cursor->getWeight();
 }
 
+// specialization for csrDelta: the base CSR slice first, then each delta range
+
+template <typename U>
+class neighborhood_iter<csrDelta<U>> {
+    friend class neighborhood<csrDelta<U>>;
+private:
+    U* cursor;
+    U* range_end;
+    const std::vector<delta_range<U>>* ranges;
+    size_t next_range;
+
+    void skip_empty() {
+        while (cursor == range_end) {
+            if (next_range == ranges->size()) {
+                cursor = nullptr;
+                return;
+            }
+            cursor = (*ranges)[next_range].begin;
+            range_end = (*ranges)[next_range].end;
+            next_range++;
+        }
+    }
+public:
+    neighborhood_iter(csrDelta<U>* ds, NodeID n, bool in_neigh) {
+        csr_delta_store<U> &s = in_neigh ? ds->in : ds->out;
+        cursor = s.base->neighbors.data() + s.base->offsets[n];
+        range_end = s.base->neighbors.data() + s.base->offsets[n + 1];
+        ranges = &s.ranges[n];
+        next_range = 0;
+        skip_empty();
+    }
+
+    bool operator!=(const neighborhood_iter<csrDelta<U>>& it) {
+        return cursor != it.cursor;
+    }
+
+    neighborhood_iter& operator++() {
+        ++cursor;
+        skip_empty();
+        return *this;
+    }
+
+    neighborhood_iter& operator++(int) {
+        ++cursor;
+        skip_empty();
+        return *this;
+    }
+
+    NodeID operator*() {
+        return cursor->getNodeID();
+    }
+
+    Weight extractWeight() {
+        return cursor->getWeight();
+    }
+};
+
+// specialization for pcsr: walk the packed array, hopping over leaf gaps
+
+template <typename U>
+class neighborhood_iter<pcsr<U>> {
+    friend class neighborhood<pcsr<U>>;
+private:
+    pma<U>* edges;
+    NodeID node;
+    int64_t slot;
+    U* cursor;
+
+    void next() {
+        slot = edges->next_slot(slot);
+        if (slot == edges->capacity() || edges->srcs[slot] != node)
+            cursor = nullptr;
+        else
+            cursor = &edges->nbs[slot];
+    }
+public:
+    neighborhood_iter(pcsr<U>* ds, NodeID n, bool in_neigh):
+        edges(in_neigh ? &ds->in : &ds->out),
+        node(n),
+        slot(edges->vertex_start[n]) {
+        cursor = slot < 0 ? nullptr : &edges->nbs[slot];
+    }
+
+    bool operator!=(const neighborhood_iter<pcsr<U>>& it) {
+        return cursor != it.cursor;
+    }
+
+    neighborhood_iter& operator++() {
+        next();
+        return *this;
+    }
+
+    neighborhood_iter& operator++(int) {
+        next();
+        return *this;
+    }
+
+    NodeID operator*() {
+        return cursor->getNodeID();
+    }
+
+    Weight extractWeight() {
+        return cursor->getWeight();
+    }
+};
+
+// specialization for adListCompressed: blocks are decoded one entry at a time
+
+template <>
+class neighborhood_iter<adListCompressed> {
+    friend class neighborhood<adListCompressed>;
+private:
+    const std::vector<compressed_block>* blocks;
+    bool weighted;
+    size_t block;
+    uint32_t remaining;     // entries left in the current block, current one included
+    const uint8_t* cursor;  // encoding of the current entry, nullptr at the end
+    const uint8_t* next_entry;
+    NodeID id;
+    Weight weight;
+
+    void decode() {
+        next_entry = cursor;
+        id += varint_decode(next_entry);
+        if (weighted)
+            weight = zigzag_decode(varint_decode(next_entry));
+    }
+
+    void load_block() {
+        if (block == blocks->size() || (*blocks)[block].count == 0) {
+            cursor = nullptr;
+            return;
+        }
+        cursor = (*blocks)[block].bytes.data();
+        remaining = (*blocks)[block].count;
+        id = 0;
+        decode();
+    }
+public:
+    neighborhood_iter(adListCompressed* ds, NodeID n, bool in_neigh):
+        blocks(in_neigh ? &ds->in_neighbors[n].blocks : &ds->out_neighbors[n].blocks),
+        weighted(ds->weighted), block(0), remaining(0), weight(-1) {
+        load_block();
+    }
+
+    bool operator!=(const neighborhood_iter<adListCompressed>& it) {
+        return cursor != it.cursor;
+    }
+
+    neighborhood_iter& operator++() {
+        if (--remaining == 0) {
+            block++;
+            load_block();
+        } else {
+            cursor = next_entry;
+            decode();
+        }
+        return *this;
+    }
+
+    neighborhood_iter& operator++(int) {
+        return ++(*this);
+    }
+
+    NodeID operator*() {
+        return id;
+    }
+
+    Weight extractWeight() {
+        return weight;
+    }
+};
+
+// specialization for edgeLog: the cached unarchived tail first, then the
+// archived entries the tail does not override
+
+template <typename U>
+class neighborhood_iter<edgeLog<U>> {
+    friend class neighborhood<edgeLog<U>>;
+private:
+    const std::vector<U>* tail;     // sorted by ID, owned by the log
+    size_t tail_pos;
+    log_chunk<U>* chunk;
+    int64_t chunk_pos;
+    int64_t remaining;      // archived entries not visited yet
+    const U* cursor;        // current archived entry, or the tail marker; nullptr at the end
+
+    const U& current() const {
+        return tail_pos < tail->size() ? (*tail)[tail_pos] : *cursor;
+    }
+
+    void next_archived() {
+        auto by_id = [](const U &a, const U &b) { return a.getNodeID() < b.getNodeID(); };
+        while (remaining > 0) {
+            if (chunk_pos == chunk->capacity) {
+                chunk = __atomic_load_n(&chunk->next, __ATOMIC_ACQUIRE);
+                chunk_pos = 0;
+            }
+            const U* nb = &chunk->edges[chunk_pos++];
+            remaining--;
+            if (!std::binary_search(tail->begin(), tail->end(), *nb, by_id)) {
+                cursor = nb;
+                return;
+            }
+        }
+        cursor = nullptr;
+    }
+public:
+    neighborhood_iter(): tail(nullptr), tail_pos(0), chunk(nullptr), chunk_pos(0), remaining(0), cursor(nullptr) {}
+
+    void set_begin(edgeLog<U>* ds, NodeID n, bool in_neigh) {
+        const log_side<U> &side = in_neigh ? ds->in : ds->out;
+        // tail entries archived since update() cached them show up in both
+        // and are dropped from the archived part
+        tail = &side.tails[n];
+        remaining = side.length(n);
+        chunk = __atomic_load_n(&side.lists[n].first, __ATOMIC_ACQUIRE);
+        if (!tail->empty())
+            cursor = tail->data();
+        else
+            next_archived();
+    }
+
+    bool operator!=(const neighborhood_iter<edgeLog<U>>& it) {
+        return cursor != it.cursor;
+    }
+
+    neighborhood_iter& operator++() {
+        if (tail_pos < tail->size() && ++tail_pos < tail->size())
+            return *this;
+        next_archived();
+        return *this;
+    }
+
+    neighborhood_iter& operator++(int) {
+        return ++(*this);
+    }
+
+    NodeID operator*() {
+        return current().getNodeID();
+    }
+
+    Weight extractWeight() {
+        return current().getWeight();
+    }
+};
+
+// specialization for csrGraph: a plain slice of the snapshot arrays
+
+template <typename U>
+class neighborhood_iter<csrGraph<U>> {
+    friend class neighborhood<csrGraph<U>>;
+private:
+    const U* cursor;
+public:
+    explicit neighborhood_iter(const U* _cursor): cursor(_cursor) {}
+
+    bool operator!=(const neighborhood_iter<csrGraph<U>>& it) {
+        return cursor != it.cursor;
+    }
+
+    neighborhood_iter& operator++() {
+        ++cursor;
+        return *this;
+    }
+
+    neighborhood_iter& operator++(int) {
+        ++cursor;
+        return *this;
+    }
+
+    NodeID operator*() {
+        return cursor->getNodeID();
+    }
+
+    Weight extractWeight() {
+        return cursor->getWeight();
+    }
+};
+
 template <typename T>
 class neighborhood {
 private:
@@ -481,6 +742,41 @@ public:
     }
 };
 
+template <typename U>
+class neighborhood<edgeLog<U>> {
+private:
+    using iter = neighborhood_iter<edgeLog<U>>;
+    NodeID src;
+    edgeLog<U> *ds;
+    bool in;
+public:
+    neighborhood(NodeID src, edgeLog<U> *ds, bool in): src(src), ds(ds), in(in) {}
+    iter begin() {
+        iter it;
+        it.set_begin(ds, src, in);
+        return it;
+    }
+    iter end() {
+        return iter();
+    }
+};
+
+template <typename U>
+class neighborhood<csrGraph<U>> {
+private:
+    using iter = neighborhood_iter<csrGraph<U>>;
+    const csr_snapshot<U>* csr;
+    NodeID src;
+public:
+    neighborhood(NodeID src, csrGraph<U> *ds, bool in): csr(in ? &ds->in : &ds->out), src(src) {}
+    iter begin() {
+        return iter(csr->neighbors.data() + csr->offsets[src]);
+    }
+    iter end() {
+        return iter(csr->neighbors.data() + csr->offsets[src + 1]);
+    }
+};
+
 template<typename T>
 neighborhood<T> in_neigh(NodeID n, T* ds)
 {
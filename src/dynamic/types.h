@@ -6,6 +6,7 @@
 #include <limits>
 #include <map>
 #include <queue>
+#include <type_traits>
 #include <vector>
 
 /* Basic building blocks for node and its variations, typedefs. */
@@ -28,54 +29,56 @@ public:
     }
 };
 
-class BaseNode {
-    public: 
-      virtual NodeID getNodeID() const = 0;  
-      virtual Weight getWeight() const = 0;  
-      virtual void setInfo(NodeID n, Weight w) = 0;
-      virtual void printNode() const = 0;      
-};
+/* Neighbor entries stored in the adjacency structures. They are plain
+   trivially-copyable structs with non-virtual accessors: no vptr per entry,
+   and the accessors inline into the traversal loops. The data structures
+   are templated on the entry type, so both share the same interface. */
 
-class Node: public BaseNode {
-private:
+struct Node {
     NodeID node;
-public:
-    Node(): node(-1){}
-    Node(NodeID n):node(n){}
-    void setInfo(NodeID n, Weight w){
+
+    Node(): node(-1) {}
+    Node(NodeID n): node(n) {}
+    void setInfo(NodeID n, Weight w) {
 	(void)w;
 	node = n;
     }
     NodeID getNodeID() const {return node;}
     Weight getWeight() const {return -1;}
-    void printNode() const{
+    void printNode() const {
 	std::cout << node << "  ";
     }
-}; 
+};
 
-class NodeWeight: public BaseNode {
+struct NodeWeight {
     NodeID node;
     Weight weight;
-    public: 
-       NodeWeight():node(-1), weight(-1){}
-       NodeWeight(NodeID n):node(n), weight(-1){}
-       NodeWeight(NodeID n, Weight w): node(n), weight(w) {}
-       void setInfo(NodeID n, Weight w){
-           node = n; weight = w;
-       }
-       Weight getWeight() const {return weight;}
-       NodeID getNodeID() const {return node;}
-       void printNode() const{
-	   std::cout << "(" << node << "," << weight  << ")" << "  ";
-       }
-       bool operator< (const NodeWeight& rhs) const {
-           return node == rhs.getNodeID() ? weight < rhs.getWeight() : node < rhs.getNodeID();
-       }
-       bool operator== (const NodeWeight& rhs) const {
-           return (node == rhs.getNodeID()) && (weight == rhs.getWeight());
-       }   
+
+    NodeWeight(): node(-1), weight(-1) {}
+    NodeWeight(NodeID n): node(n), weight(-1) {}
+    NodeWeight(NodeID n, Weight w): node(n), weight(w) {}
+    void setInfo(NodeID n, Weight w) {
+        node = n; weight = w;
+    }
+    Weight getWeight() const {return weight;}
+    NodeID getNodeID() const {return node;}
+    void printNode() const {
+        std::cout << "(" << node << "," << weight  << ")" << "  ";
+    }
+    bool operator< (const NodeWeight& rhs) const {
+        return node == rhs.node ? weight < rhs.weight : node < rhs.node;
+    }
+    bool operator== (const NodeWeight& rhs) const {
+        return (node == rhs.node) && (weight == rhs.weight);
+    }
 };
 
+static_assert(std::is_trivially_copyable<Node>::value && sizeof(Node) == sizeof(NodeID),
+              "Node must stay a plain NodeID");
+static_assert(std::is_trivially_copyable<NodeWeight>::value &&
+              sizeof(NodeWeight) == sizeof(NodeID) + sizeof(Weight),
+              "NodeWeight must stay a plain (NodeID, Weight) pair");
+
 struct Edge {
     NodeID source;
     NodeID destination;
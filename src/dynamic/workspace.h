@@ -0,0 +1,73 @@
+#ifndef WORKSPACE_H_
+#define WORKSPACE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "types.h"
+#include "sliding_queue_dynamic.h"
+#include "bitmap.h"
+#include "hub_split.h"
+
+/* Buffers an incremental algorithm keeps across batches.
+
+   The frontier queue and scratch arrays are allocated once and only grow
+   with the graph. Visited sets are epoch-stamped: a vertex is in the set if
+   its stamp equals the current epoch, so clearing the set between
+   propagation rounds is a single increment instead of an O(n) fill. */
+
+class epoch_set {
+    std::vector<uint32_t> stamps;
+    uint32_t epoch = 0;
+
+public:
+    // empties the set and makes room for n vertices
+    void reset(int64_t n) {
+        if (static_cast<int64_t>(stamps.size()) < n)
+            stamps.resize(std::max<int64_t>(n, 2 * stamps.size()), 0);
+        if (++epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    // returns true if v was not in the set yet; thread-safe
+    bool insert(NodeID v) {
+        uint32_t s = stamps[v];
+        if (s == epoch)
+            return false;
+        return __sync_bool_compare_and_swap(&stamps[v], s, epoch);
+    }
+
+    bool contains(NodeID v) const {
+        return stamps[v] == epoch;
+    }
+};
+
+class algo_workspace {
+    std::unique_ptr<SlidingQueue<NodeID>> queue;
+    int64_t queue_capacity = 0;
+
+public:
+    epoch_set visited;
+    std::vector<float> scratch;     // per-vertex values, e.g. PR contributions kept across batches
+    std::vector<uint64_t> masks;        // per-vertex bitmasks, e.g. MS-BFS landmark sets
+    std::vector<uint64_t> next_masks;   // same, for the next round
+    Bitmap front, next_front;           // bitmap frontiers for pull rounds
+    hub_split hubs;                     // high-degree vertices of the current round
+
+    // empty frontier queue with room for n vertices
+    SlidingQueue<NodeID>& frontier(int64_t n) {
+        if (queue_capacity < n) {
+            queue_capacity = std::max(n, 2 * queue_capacity);
+            queue.reset(new SlidingQueue<NodeID>(queue_capacity));
+        } else {
+            queue->reset();
+        }
+        return *queue;
+    }
+};
+
+#endif  // WORKSPACE_H_
@@ -5,6 +5,8 @@
  *   below must be reserved in your application and CANNOT be
  *   considered a normal value.  Feel free to change the value to
  *   suit your application.
+ * - Waiters back off exponentially and eventually yield the core, see
+ *   FE_BACKOFF_MAX_SPINS.
  * - Improper use of these functions can and will result in deadlock.
  *
  * author: rmccoll3@gatech.edu
@@ -13,62 +15,144 @@
 #include  "x86_full_empty.h"
 #include <stdlib.h>
 #include <stdint.h>
+#include <sched.h>
+
+/* Exponential backoff state of a single acquisition. */
+typedef struct fe_backoff {
+  int64_t delay;
+  int64_t spins;
+  int64_t yields;
+} fe_backoff;
+
+static inline void
+fe_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#else
+  __sync_synchronize();
+#endif
+}
+
+static inline void
+fe_backoff_wait(fe_backoff * b) {
+  b->spins++;
+  if(b->delay < FE_BACKOFF_MAX_SPINS) {
+    for(int64_t i = 0; i < b->delay; i++)
+      fe_cpu_relax();
+    b->delay <<= 1;
+  } else {
+    sched_yield();
+    b->yields++;
+  }
+}
+
+static inline void
+fe_backoff_done(fe_backoff * b, fe_lock_stats * stats) {
+  if(b->spins && stats) {
+    stinger_int64_fetch_add(&stats->contended, 1);
+    stinger_int64_fetch_add(&stats->spins, b->spins);
+    if(b->yields)
+      stinger_int64_fetch_add(&stats->yields, b->yields);
+  }
+}
+
+void
+fe_lock_stats_reset(fe_lock_stats * stats) {
+  stats->contended = 0;
+  stats->spins = 0;
+  stats->yields = 0;
+}
 
 int64_t
-readfe(volatile int64_t * v) {
+readfe_stats(volatile int64_t * v, fe_lock_stats * stats) {
+  fe_backoff b = {1, 0, 0};
   stinger_memory_barrier();
   int64_t val;
   while(1) {
     val = *v;
     while(val == MARKER) {
+      fe_backoff_wait(&b);
       val = *v;
     }
-    if(val == stinger_int64_cas(v, val, MARKER))
+    if(val == stinger_int64_cas((int64_t *)v, val, MARKER))
       break;
+    fe_backoff_wait(&b);
   }
+  fe_backoff_done(&b, stats);
   return val;
 }
 
 int64_t
-writeef(volatile int64_t * v, int64_t new_val) {
+writeef_stats(volatile int64_t * v, int64_t new_val, fe_lock_stats * stats) {
+  fe_backoff b = {1, 0, 0};
   stinger_memory_barrier();
   int64_t val;
   while(1) {
     val = *v;
     while(val != MARKER) {
+      fe_backoff_wait(&b);
       val = *v;
     }
-    if(MARKER == stinger_int64_cas(v, MARKER, new_val))
+    if(MARKER == stinger_int64_cas((int64_t *)v, MARKER, new_val))
       break;
+    fe_backoff_wait(&b);
   }
+  fe_backoff_done(&b, stats);
   return val;
 }
 
 int64_t
-readff(volatile int64_t * v) {
+readff_stats(volatile int64_t * v, fe_lock_stats * stats) {
+  fe_backoff b = {1, 0, 0};
   stinger_memory_barrier();
   int64_t val = *v;
   while(val == MARKER) {
+    fe_backoff_wait(&b);
     val = *v;
   }
+  fe_backoff_done(&b, stats);
   return val;
 }
 
 int64_t
-writeff(volatile int64_t * v, int64_t new_val) {
+writeff_stats(volatile int64_t * v, int64_t new_val, fe_lock_stats * stats) {
+  fe_backoff b = {1, 0, 0};
   stinger_memory_barrier();
   int64_t val;
   while(1) {
     val = *v;
     while(val == MARKER) {
+      fe_backoff_wait(&b);
       val = *v;
     }
-    if(val == stinger_int64_cas(v, val, new_val))
+    if(val == stinger_int64_cas((int64_t *)v, val, new_val))
       break;
+    fe_backoff_wait(&b);
   }
+  fe_backoff_done(&b, stats);
   return val;
 }
 
+int64_t
+readfe(volatile int64_t * v) {
+  return readfe_stats(v, NULL);
+}
+
+int64_t
+writeef(volatile int64_t * v, int64_t new_val) {
+  return writeef_stats(v, new_val, NULL);
+}
+
+int64_t
+readff(volatile int64_t * v) {
+  return readff_stats(v, NULL);
+}
+
+int64_t
+writeff(volatile int64_t * v, int64_t new_val) {
+  return writeff_stats(v, new_val, NULL);
+}
+
 int64_t
 writexf(volatile int64_t * v, int64_t new_val) {
   stinger_memory_barrier();
@@ -90,14 +174,17 @@ writexf_bool(volatile bool * v, bool new_val) {
 bool
 readfe_bool(volatile bool * v) {
   stinger_memory_barrier();
+  fe_backoff b = {1, 0, 0};
   bool val;
   while(1) {
     val = *v;
     while(val == 0) {
+      fe_backoff_wait(&b);
       val = *v;
     }
     if(val == __sync_val_compare_and_swap(v, val, 0))
       break;
+    fe_backoff_wait(&b);
   }
   return val;
 }
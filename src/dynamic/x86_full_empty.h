@@ -26,6 +26,24 @@ extern "C" {
 #include  <stdint.h>
 #define MARKER INT64_MAX
 
+/* Waiting on a full/empty bit backs off exponentially: the waiter pauses
+   for 1, 2, 4, ... up to FE_BACKOFF_MAX_SPINS iterations between polls and
+   then yields the core on every further poll. */
+#define FE_BACKOFF_MAX_SPINS 1024
+
+/* Contention counters for one lock site. Only acquisitions that had to wait
+   touch the counters, so an uncontended lock costs nothing extra. Padded to
+   a cache line so neighbouring sites do not false-share. */
+typedef struct fe_lock_stats {
+  int64_t contended;  /**< acquisitions that found the word locked or lost the CAS */
+  int64_t spins;      /**< total failed polls over those acquisitions */
+  int64_t yields;     /**< polls that gave up the core with sched_yield */
+  int64_t pad[5];
+} fe_lock_stats;
+
+void
+fe_lock_stats_reset(fe_lock_stats * stats);
+
 int64_t 
 readfe(volatile int64_t * v);
 
@@ -42,6 +60,19 @@ int64_t
 writexf(volatile int64_t * v, int64_t new_val);
 
 
+/* Same as above, counting contention into stats (may be NULL). */
+int64_t
+readfe_stats(volatile int64_t * v, fe_lock_stats * stats);
+
+int64_t
+writeef_stats(volatile int64_t * v, int64_t new_val, fe_lock_stats * stats);
+
+int64_t
+readff_stats(volatile int64_t * v, fe_lock_stats * stats);
+
+int64_t
+writeff_stats(volatile int64_t * v, int64_t new_val, fe_lock_stats * stats);
+
 bool
 writexf_bool(volatile bool * v, bool new_val);
 bool